@@ -20,6 +20,8 @@
 #include <src/can/can_endpoints.h>
 #include <src/motor/motor.h>
 #include <src/controller/controller.h>
+#include <src/gatedriver/gatedriver.h>
+#include <src/scheduler/scheduler.h>
 #include <src/adc/adc.h>
 
 #define AIO0to5_DIFF_AMP_MODE 0x40u
@@ -60,7 +62,9 @@ static ADCConfig adc_config = {
     .I_phase_offset = {0},
     .Iphase_limit = 60.0f,
     .I_phase_offset_tau = 0.1f,
-    .temp_tau = 1.0
+    .temp_tau = 1.0,
+    .I_phase_offset_track_tau = 10.0f,
+    .I_phase_offset_tracking = false
 };
 
 void ADC_init(void)
@@ -68,6 +72,8 @@ void ADC_init(void)
     // Compute tau-dependent variables
     adc_state.I_phase_offset_D = 1.0f - powf(EPSILON, -1.0f / (adc_config.I_phase_offset_tau * PWM_FREQ_HZ));
     adc_state.temp_D = 1.0f - powf(EPSILON, -1.0f / (adc_config.temp_tau * PWM_FREQ_HZ));
+    adc_state.temp_D_shed = 1.0f - powf(EPSILON, -(float)SHED_TEMP_DECIMATION / (adc_config.temp_tau * PWM_FREQ_HZ));
+    adc_state.I_phase_offset_track_D = 1.0f - powf(EPSILON, -1.0f / (adc_config.I_phase_offset_track_tau * PWM_FREQ_HZ));
 
     // --- Begin CAFE2 Initialization
 
@@ -234,14 +240,64 @@ void ADC_DTSE_Init(void)
     pac5xxx_dtse_seq_config(18, ADC0, 0, ADC_IRQ0_EN, SEQ_END); // Get result at DTSERES18, Interrupt
 }
 
+// Averages the raw offset samples until their mean settles, or for
+// at most max_len cycles.
+static void ADC_average_offsets(FloatTriplet *mean, uint32_t max_len)
+{
+    ConvergenceMonitor monitors[3] = {0};
+    FloatTriplet sum = {0.0f};
+    uint32_t i = 0;
+    bool converged = false;
+    while ((i < max_len) && (converged == false))
+    {
+        wait_for_control_loop_interrupt();
+        const float offset_a = (float)PAC55XX_ADC->DTSERES6.VAL * SHUNT_SCALING_FACTOR;
+        const float offset_b = (float)PAC55XX_ADC->DTSERES8.VAL * SHUNT_SCALING_FACTOR;
+        const float offset_c = (float)PAC55XX_ADC->DTSERES10.VAL * SHUNT_SCALING_FACTOR;
+        sum.A += offset_a;
+        sum.B += offset_b;
+        sum.C += offset_c;
+        converged = convergence_update(&monitors[0], offset_a, CAL_CONV_BLOCK_LEN, CAL_OFFSET_TOL);
+        converged &= convergence_update(&monitors[1], offset_b, CAL_CONV_BLOCK_LEN, CAL_OFFSET_TOL);
+        converged &= convergence_update(&monitors[2], offset_c, CAL_CONV_BLOCK_LEN, CAL_OFFSET_TOL);
+        i++;
+    }
+    mean->A = sum.A / i;
+    mean->B = sum.B / i;
+    mean->C = sum.C / i;
+}
+
 bool ADC_calibrate_offset(void)
 {
-    // We only need to wait here, the ADC loop will
-    // perform the offset calibration automatically
-    wait_pwm_cycles(10000);
+    // The ADC loop keeps tracking offsets throughout calibration, but
+    // its filter takes long to settle from zero. Instead, the offsets
+    // are set directly to the mean of the raw samples.
+    ADC_average_offsets(&(adc_config.I_phase_offset), CAL_OFFSET_MAX_LEN);
     return true;
 }
 
+bool ADC_get_offset_calibrated(void)
+{
+    // Offsets are zeroed on reset, and a real offset is never zero
+    return (adc_config.I_phase_offset.A != 0.0f)
+        && (adc_config.I_phase_offset.B != 0.0f)
+        && (adc_config.I_phase_offset.C != 0.0f);
+}
+
+bool ADC_verify_offset(void)
+{
+    // The ADC loop tracks offsets toward the samples throughout
+    // calibration, so the stored offsets are set aside beforehand and
+    // restored after averaging.
+    const FloatTriplet stored = adc_config.I_phase_offset;
+    FloatTriplet mean;
+    ADC_average_offsets(&mean, CAL_VERIFY_LEN);
+    adc_config.I_phase_offset = stored;
+    return (our_fabsf(mean.A - stored.A) < CAL_VERIFY_OFFSET_TOL)
+        && (our_fabsf(mean.B - stored.B) < CAL_VERIFY_OFFSET_TOL)
+        && (our_fabsf(mean.C - stored.C) < CAL_VERIFY_OFFSET_TOL);
+}
+
 TM_RAMFUNC float ADC_get_mcu_temp(void)
 {
     return adc_state.temp;
@@ -254,32 +310,96 @@ TM_RAMFUNC void ADC_get_phase_currents(FloatTriplet *phc)
     phc->C = adc_state.I_phase_meas.C;
 }
 
+static inline void ADC_update_offsets(float D)
+{
+    adc_config.I_phase_offset.A += (((float)PAC55XX_ADC->DTSERES6.VAL * SHUNT_SCALING_FACTOR) - adc_config.I_phase_offset.A) * D;
+    adc_config.I_phase_offset.B += (((float)PAC55XX_ADC->DTSERES8.VAL * SHUNT_SCALING_FACTOR) - adc_config.I_phase_offset.B) * D;
+    adc_config.I_phase_offset.C += (((float)PAC55XX_ADC->DTSERES10.VAL * SHUNT_SCALING_FACTOR) - adc_config.I_phase_offset.C) * D;
+}
+
+// Whether the offset samples of sequence A were taken while no
+// current flowed through the shunts, i.e. either with the gate
+// driver disabled, or within the high-side zero vector.
+static inline bool ADC_offset_sample_valid(controller_state_options state, const FloatTriplet *dc)
+{
+    if (gate_driver_is_enabled() == false)
+    {
+        return true;
+    }
+    else if (state == CONTROLLER_STATE_CL_CONTROL)
+    {
+        return (dc->A > OFFSET_TRACK_MIN_DUTY) && (dc->B > OFFSET_TRACK_MIN_DUTY) && (dc->C > OFFSET_TRACK_MIN_DUTY);
+    }
+    return false;
+}
+
 TM_RAMFUNC void ADC_update(void)
 {
-    switch (controller_get_state())
+    const controller_state_options state = controller_get_state();
+    // Duty cycles applied during the current PWM period
+    FloatTriplet dc;
+    controller_get_modulation_values(&dc);
+
+    if ((state != CONTROLLER_STATE_CALIBRATE) && adc_config.I_phase_offset_tracking && ADC_offset_sample_valid(state, &dc))
+    {
+        ADC_update_offsets(adc_state.I_phase_offset_track_D);
+    }
+
+    switch (state)
     {
         case CONTROLLER_STATE_CALIBRATE:
         {
-            adc_config.I_phase_offset.A += (((float)PAC55XX_ADC->DTSERES6.VAL * SHUNT_SCALING_FACTOR) - adc_config.I_phase_offset.A) * adc_state.I_phase_offset_D;
-            adc_config.I_phase_offset.B += (((float)PAC55XX_ADC->DTSERES8.VAL * SHUNT_SCALING_FACTOR) - adc_config.I_phase_offset.B) * adc_state.I_phase_offset_D;
-            adc_config.I_phase_offset.C += (((float)PAC55XX_ADC->DTSERES10.VAL * SHUNT_SCALING_FACTOR) - adc_config.I_phase_offset.C) * adc_state.I_phase_offset_D;
+            ADC_update_offsets(adc_state.I_phase_offset_D);
         }
         case CONTROLLER_STATE_CL_CONTROL:
         {
             const float i_a = (((float)PAC55XX_ADC->DTSERES14.VAL * SHUNT_SCALING_FACTOR) - adc_config.I_phase_offset.A);
             const float i_b = (((float)PAC55XX_ADC->DTSERES16.VAL * SHUNT_SCALING_FACTOR) - adc_config.I_phase_offset.B);
             const float i_c = (((float)PAC55XX_ADC->DTSERES18.VAL * SHUNT_SCALING_FACTOR) - adc_config.I_phase_offset.C);
-            adc_state.I_phase_meas.A = ((1.0f - I_FILTER_K) * i_a) - (I_FILTER_K * (i_b + i_c));
-            adc_state.I_phase_meas.B = ((1.0f - I_FILTER_K) * i_b) - (I_FILTER_K * (i_a + i_c));
-            adc_state.I_phase_meas.C = ((1.0f - I_FILTER_K) * i_c) - (I_FILTER_K * (i_a + i_b));
+            // The phase with the highest duty has the shortest low-side window.
+            // If it is too short, use the other two phases and Kirchhoff's law.
+            // Calibration drives the gates directly, so dc only applies in closed loop.
+            const bool two_shunt = (state == CONTROLLER_STATE_CL_CONTROL) &&
+                ((dc.A > TWO_SHUNT_MAX_DUTY) || (dc.B > TWO_SHUNT_MAX_DUTY) || (dc.C > TWO_SHUNT_MAX_DUTY));
+            if (two_shunt && (dc.A >= dc.B) && (dc.A >= dc.C))
+            {
+                adc_state.I_phase_meas.A = -(i_b + i_c);
+                adc_state.I_phase_meas.B = i_b;
+                adc_state.I_phase_meas.C = i_c;
+            }
+            else if (two_shunt && (dc.B >= dc.C))
+            {
+                adc_state.I_phase_meas.A = i_a;
+                adc_state.I_phase_meas.B = -(i_a + i_c);
+                adc_state.I_phase_meas.C = i_c;
+            }
+            else if (two_shunt)
+            {
+                adc_state.I_phase_meas.A = i_a;
+                adc_state.I_phase_meas.B = i_b;
+                adc_state.I_phase_meas.C = -(i_a + i_b);
+            }
+            else
+            {
+                adc_state.I_phase_meas.A = ((1.0f - I_FILTER_K) * i_a) - (I_FILTER_K * (i_b + i_c));
+                adc_state.I_phase_meas.B = ((1.0f - I_FILTER_K) * i_b) - (I_FILTER_K * (i_a + i_c));
+                adc_state.I_phase_meas.C = ((1.0f - I_FILTER_K) * i_c) - (I_FILTER_K * (i_a + i_b));
+            }
         }
         default: break;
     }
     
-    // Temperature in oC at time of internal temperature sensor
-    const float FTTEMP = 27 + 273; // READ_UINT16(0x0010041E);
-    const float temp_val = (float)(PAC55XX_ADC->DTSERES2.VAL);
-    adc_state.temp = ( ((FTTEMP * (temp_val + 122.88f)) / (adc_state.temp_cal_const + 122.88f)) - 273) * adc_state.temp_D + adc_state.temp * (1.0f - adc_state.temp_D);
+    // Under overload the temperature filter is updated at a fraction of
+    // the rate, with a coefficient giving the same time constant
+    const bool temp_shed = scheduler_sheds(SCHEDULER_DEGRADATION_TEMPERATURE);
+    if (!temp_shed || (scheduler_state.cycle % SHED_TEMP_DECIMATION == 0))
+    {
+        const float temp_D = temp_shed ? adc_state.temp_D_shed : adc_state.temp_D;
+        // Temperature in oC at time of internal temperature sensor
+        const float FTTEMP = 27 + 273; // READ_UINT16(0x0010041E);
+        const float temp_val = (float)(PAC55XX_ADC->DTSERES2.VAL);
+        adc_state.temp = ( ((FTTEMP * (temp_val + 122.88f)) / (adc_state.temp_cal_const + 122.88f)) - 273) * temp_D + adc_state.temp * (1.0f - temp_D);
+    }
 
     // // Internal MCU temperature sensor reading at FTTEMP temperature in ADC counts.
     // uint16_t TTEMPS = 0;
@@ -290,6 +410,30 @@ TM_RAMFUNC void ADC_update(void)
     // adc_state.temp = ((((FTTEMP + 273) * ((temp_val * 100) + 12288)) / (((int16_t)TTEMPS * 100) + 12288)) - 273);
 }
 
+bool ADC_get_offset_tracking(void)
+{
+    return adc_config.I_phase_offset_tracking;
+}
+
+void ADC_set_offset_tracking(bool enabled)
+{
+    adc_config.I_phase_offset_tracking = enabled;
+}
+
+float ADC_get_offset_tracking_tau(void)
+{
+    return adc_config.I_phase_offset_track_tau;
+}
+
+void ADC_set_offset_tracking_tau(float tau)
+{
+    if (tau > 0.0f)
+    {
+        adc_config.I_phase_offset_track_tau = tau;
+        adc_state.I_phase_offset_track_D = 1.0f - powf(EPSILON, -1.0f / (tau * PWM_FREQ_HZ));
+    }
+}
+
 ADCConfig *ADC_get_config(void)
 {
     return &adc_config;
@@ -87,12 +87,24 @@ typedef enum
 
 #define I_FILTER_K (0.6f)
 
+// Sequence A samples the shunts just after the PWM counter starts,
+// while all high-side switches conduct and no current flows through
+// the shunts, provided every phase duty is above this value.
+#define OFFSET_TRACK_MIN_DUTY (0.45f)
+
+// Above this duty the low-side conduction window of a phase becomes
+// too short for a settled current sample around the PWM peak, and
+// the phase current is reconstructed from the other two instead.
+#define TWO_SHUNT_MAX_DUTY (0.8f)
+
 typedef struct 
 {
     float temp;
     float temp_cal_const;
     float temp_D;
+    float temp_D_shed;
     float I_phase_offset_D;
+    float I_phase_offset_track_D;
     FloatTriplet I_phase_meas;
 } ADCState;
 
@@ -102,14 +114,22 @@ typedef struct
     float Iphase_limit;
     float I_phase_offset_tau;
     float temp_tau;
+    float I_phase_offset_track_tau;
+    bool I_phase_offset_tracking;
 } ADCConfig;
 
 void ADC_init(void);
 void ADC_reset(void);
 bool ADC_calibrate_offset(void);
+bool ADC_get_offset_calibrated(void);
+bool ADC_verify_offset(void);
 float ADC_get_mcu_temp(void);
 void ADC_get_phase_currents(FloatTriplet *phc);
 void ADC_update(void);
+bool ADC_get_offset_tracking(void);
+void ADC_set_offset_tracking(bool enabled);
+float ADC_get_offset_tracking_tau(void);
+void ADC_set_offset_tracking_tau(float tau);
 
 ADCConfig *ADC_get_config(void);
 void ADC_restore_config(ADCConfig *config_);
@@ -17,6 +17,7 @@
 #include <string.h>
 
 #include <src/utils/utils.h>
+#include <src/scheduler/scheduler.h>
 #include <src/watchdog/watchdog.h>
 #include <src/can/can_endpoints.h>
 #include <src/can/can_func.h>
@@ -33,7 +34,8 @@
 static CANConfig config = {
     .id = 1,
     .kbaud_rate = CAN_BAUD_1000KHz,
-    .heartbeat_period = 1000
+    .heartbeat_period = 1000,
+    .broadcast_id = 0
 };
 
 static CANState can_state ={
@@ -42,11 +44,42 @@ static CANState can_state ={
     .send_heartbeat = true
 };
 
+static CANTxQueue tx_queues[CAN_TX_PRIORITY_COUNT] = {0};
+static const uint8_t tx_queue_lengths[CAN_TX_PRIORITY_COUNT] = CAN_TX_QUEUE_LENGTHS;
+
+static CANRxQueue rx_queues[CAN_RX_PRIORITY_COUNT] = {0};
+static const uint8_t rx_queue_lengths[CAN_RX_PRIORITY_COUNT] = CAN_RX_QUEUE_LENGTHS;
+
+// Endpoints whose frames are processed ahead of others
+static uint8_t (*const setpoint_endpoints[])(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd) = {
+    &avlos_controller_position_setpoint,
+    &avlos_controller_position_set_setpoint_turns,
+    &avlos_controller_velocity_setpoint,
+    &avlos_controller_current_Iq_setpoint,
+    &avlos_controller_set_pos_vel_setpoints
+};
+
 extern volatile uint32_t msTicks;
 
 const uint8_t avlos_proto_hash_8 = (uint8_t)(avlos_proto_hash & 0xFF);
 const size_t endpoint_count = sizeof(avlos_endpoints) / sizeof(avlos_endpoints[0]);
 
+static inline uint8_t node_id_from_arbitration(uint32_t arb_id)
+{
+    return (arb_id & CAN_DEV_MASK) >> (CAN_EP_SIZE + CAN_HASH_SIZE);
+}
+
+// In dual filter mode, each filter compares ID28..13 of extended frames,
+// ie. the node ID and the upper hash bits. Only the node ID is compared,
+// by the first filter against this node and by the second against the
+// broadcast ID. Must be called in reset mode.
+static void can_set_filters(void)
+{
+    const uint8_t second_id = config.broadcast_id > 0 ? config.broadcast_id : config.id;
+    PAC55XX_CAN->AMR = 0xFF00FF00;
+    PAC55XX_CAN->ACR = (config.id & 0xFF) | ((uint32_t)second_id << 16);
+}
+
 void CAN_init(void)
 {
 #if defined(BOARD_REV_R53)
@@ -99,7 +132,7 @@ void CAN_init(void)
     can_io_config(CAN_BUS_PINS);
 
     pac5xxx_can_reset_mode_set(1); // CAN in reset mode, in order to configure CAN module
-    PAC55XX_CAN->MR.AFM = 1;       // Single filter scheme
+    PAC55XX_CAN->MR.AFM = 0;       // Dual filter scheme
 
     // This below ensures a valid value is always assigned
     can_baud(CAN_IntToBaudType(CAN_BaudTypeToInt(config.kbaud_rate)));
@@ -107,13 +140,9 @@ void CAN_init(void)
     PAC55XX_CAN->BTR0.SJW = 1; // Synchronization jump width
     PAC55XX_CAN->BTR1.SAM = 0; // Bus is sampled once
 
-    // PAC55XX_CAN->AMR = 0xFFFFFF87;
-    //PAC55XX_CAN->AMR = 0xFFFFFFFF;
-    // 11111111111111110000111100000000
-    PAC55XX_CAN->AMR = 0xFFFFFF00;
-    PAC55XX_CAN->ACR = config.id & 0xFF; // for now we only use 8 bit identifier
+    can_set_filters();
 
-    // PAC55XX_CAN->IMR.TIM = 1; // Transmit Interrupt
+    PAC55XX_CAN->IMR.TIM = 1; // Transmit Interrupt, sends the next queued frame
     PAC55XX_CAN->IMR.RIM = 1; // Receive Interrupt
     NVIC_SetPriority(CAN_IRQn, 3);
     NVIC_EnableIRQ(CAN_IRQn);
@@ -143,7 +172,24 @@ void CAN_set_ID(uint8_t id)
     {
         pac5xxx_can_reset_mode_set(1); // CAN in reset mode, in order to configure CAN module
         config.id = id;
-        PAC55XX_CAN->ACR = config.id & 0xFF; // for now we only use 8 bit identifier
+        can_set_filters();
+        pac5xxx_can_reset_mode_set(0); // CAN reset mode inactive
+        delay_us(100);
+    }
+}
+
+uint8_t CAN_get_broadcast_ID(void)
+{
+    return config.broadcast_id;
+}
+
+void CAN_set_broadcast_ID(uint8_t id)
+{
+    if (id != config.id)
+    {
+        pac5xxx_can_reset_mode_set(1); // CAN in reset mode, in order to configure CAN module
+        config.broadcast_id = id;
+        can_set_filters();
         pac5xxx_can_reset_mode_set(0); // CAN reset mode inactive
         delay_us(100);
     }
@@ -159,27 +205,228 @@ void CAN_set_send_heartbeat(bool value)
     can_state.send_heartbeat = value;
 }
 
-void CAN_process_interrupt(void)
+// Writes the highest priority queued frame to the TX buffer. Called with
+// interrupts masked, or from the CAN interrupt.
+static void can_tx_send_next(void)
+{
+    for (uint8_t p = 0; p < CAN_TX_PRIORITY_COUNT; p++)
+    {
+        CANTxQueue *q = &tx_queues[p];
+        if (q->count > 0)
+        {
+            const CANFrame *frame = &q->frames[q->head];
+            can_transmit_extended(frame->length, frame->id, frame->data);
+            q->head = (q->head + 1) % tx_queue_lengths[p];
+            q->count--;
+            can_state.tx_sent++;
+            return;
+        }
+    }
+}
+
+// Queues a frame for transmission, and starts transmitting it right away
+// if the TX buffer is free. Returns false and counts the frame as dropped
+// if its queue is full.
+bool CAN_transmit(CANTxPriority priority, uint8_t length, uint32_t id, const uint8_t *data)
+{
+    bool queued = false;
+    __disable_irq();
+    CANTxQueue *q = &tx_queues[priority];
+    if (q->count < tx_queue_lengths[priority])
+    {
+        CANFrame *frame = &q->frames[(q->head + q->count) % tx_queue_lengths[priority]];
+        frame->id = id;
+        frame->length = length;
+        memcpy(frame->data, data, length);
+        q->count++;
+        can_state.tx_queued++;
+        queued = true;
+        if (PAC55XX_CAN->SR.TBS != 0)
+        {
+            can_tx_send_next();
+        }
+    }
+    else
+    {
+        can_state.tx_dropped++;
+    }
+    __enable_irq();
+    return queued;
+}
+
+bool CAN_tx_queue_has_room(CANTxPriority priority)
+{
+    return tx_queues[priority].count < tx_queue_lengths[priority];
+}
+
+void CAN_process_tx_interrupt(void)
+{
+    if (PAC55XX_CAN->SR.TBS != 0)
+    {
+        can_tx_send_next();
+    }
+}
+
+uint32_t CAN_get_tx_queued(void)
+{
+    return can_state.tx_queued;
+}
+
+uint32_t CAN_get_tx_sent(void)
+{
+    return can_state.tx_sent;
+}
+
+uint32_t CAN_get_tx_dropped(void)
+{
+    return can_state.tx_dropped;
+}
+
+uint32_t CAN_get_rx_accepted(void)
+{
+    return can_state.rx_accepted;
+}
+
+uint32_t CAN_get_rx_rejected(void)
+{
+    return can_state.rx_rejected;
+}
+
+static inline uint8_t rx_queue_count(const CANRxQueue *q)
+{
+    return (uint8_t)(q->tail - q->head);
+}
+
+static inline CANRxPriority rx_priority(uint32_t ep_id)
+{
+    if (endpoint_count > ep_id)
+    {
+        for (uint8_t i = 0; i < sizeof(setpoint_endpoints) / sizeof(setpoint_endpoints[0]); i++)
+        {
+            if (avlos_endpoints[ep_id] == setpoint_endpoints[i])
+            {
+                return CAN_RX_PRIORITY_SETPOINT;
+            }
+        }
+    }
+    return CAN_RX_PRIORITY_OTHER;
+}
+
+// Moves all received frames from the CAN controller to the RX queues,
+// stamped with the current control cycle. Frames are dropped and
+// counted if their queue is full.
+void CAN_process_rx_interrupt(void)
+{
+    while (PAC55XX_CAN->SR.RBS != 0)
+    {
+        const bool extended = can_process_extended();
+        CANRxQueue *q = &rx_queues[extended ? rx_priority(can_ep_id) : CAN_RX_PRIORITY_OTHER];
+        const uint8_t length = rx_queue_lengths[q - rx_queues];
+        if (rx_queue_count(q) >= length)
+        {
+            can_state.rx_overflows++;
+            continue;
+        }
+        CANRxFrame *f = &q->frames[q->tail & (length - 1)];
+        f->extended = extended;
+        f->rtr = rtr;
+        f->cycle = scheduler_state.cycle;
+        f->frame.id = rx_id;
+        f->frame.length = data_length;
+        memcpy(f->frame.data, rx_data, sizeof(rx_data));
+        __DMB();
+        q->tail++;
+        const uint8_t depth = rx_queue_count(&rx_queues[CAN_RX_PRIORITY_SETPOINT])
+            + rx_queue_count(&rx_queues[CAN_RX_PRIORITY_OTHER]);
+        if (depth > can_state.rx_max_depth)
+        {
+            can_state.rx_max_depth = depth;
+        }
+    }
+}
+
+bool CAN_rx_pending(void)
 {
-    can_process_extended();
+    return (rx_queue_count(&rx_queues[CAN_RX_PRIORITY_SETPOINT]) > 0)
+        || (rx_queue_count(&rx_queues[CAN_RX_PRIORITY_OTHER]) > 0);
+}
 
-    if ((endpoint_count > can_ep_id) && 
-       ((can_frame_hash == avlos_proto_hash_8) || (can_frame_hash == 0)))
+// Processes the oldest queued frame, setpoint frames first. Frames are
+// counted as rejected if they are standard frames, or if their endpoint
+// or hash don't match.
+void CAN_process_frame(void)
+{
+    CANRxQueue *q = &rx_queues[CAN_RX_PRIORITY_SETPOINT];
+    if (rx_queue_count(q) == 0)
     {
-        uint8_t (*callback)(uint8_t buffer[], uint8_t * buffer_length, Avlos_Command cmd) = avlos_endpoints[can_ep_id];
+        q = &rx_queues[CAN_RX_PRIORITY_OTHER];
+        if (rx_queue_count(q) == 0)
+        {
+            return;
+        }
+    }
+    const CANRxFrame f = q->frames[q->head & (rx_queue_lengths[q - rx_queues] - 1)];
+    __DMB();
+    q->head++;
+
+    const uint32_t latency = scheduler_state.cycle - f.cycle;
+    if (latency > can_state.rx_max_latency)
+    {
+        can_state.rx_max_latency = latency;
+    }
+
+    uint32_t ep_id;
+    uint32_t frame_hash;
+    ids_from_arbitration(f.frame.id, &ep_id, &frame_hash);
+    const uint8_t node_id = node_id_from_arbitration(f.frame.id);
+    const bool broadcast = (config.broadcast_id > 0) && (node_id == config.broadcast_id) && (node_id != config.id);
+
+    if (f.extended && (node_id == config.id || broadcast) && (endpoint_count > ep_id) && 
+       ((frame_hash == avlos_proto_hash_8) || (frame_hash == 0)))
+    {
+        can_state.rx_accepted++;
+        uint8_t (*callback)(uint8_t buffer[], uint8_t * buffer_length, Avlos_Command cmd) = avlos_endpoints[ep_id];
         uint8_t can_msg_buffer[8];
-        memcpy(can_msg_buffer, &rx_data, data_length);
-        data_length = 0;
-        uint8_t response_type = callback(can_msg_buffer, &data_length, (uint8_t)rtr);
-        if ((AVLOS_RET_READ == response_type || AVLOS_RET_CALL == response_type) && (data_length > 0))
+        memcpy(can_msg_buffer, f.frame.data, f.frame.length);
+        uint8_t length = 0;
+        uint8_t response_type = callback(can_msg_buffer, &length, (uint8_t)f.rtr);
+        // Nodes don't respond to broadcast frames, as their responses would collide
+        if (!broadcast && (AVLOS_RET_READ == response_type || AVLOS_RET_CALL == response_type) && (length > 0))
         {
             can_state.last_msg_ms = msTicks;
-            can_transmit_extended(data_length, rx_id, can_msg_buffer);
+            CAN_transmit(CAN_TX_PRIORITY_RESPONSE, length, f.frame.id, can_msg_buffer);
         }
     }
+    else
+    {
+        can_state.rx_rejected++;
+    }
     Watchdog_reset();
 }
 
+uint32_t CAN_get_rx_overflows(void)
+{
+    return can_state.rx_overflows;
+}
+
+uint8_t CAN_get_rx_max_depth(void)
+{
+    return can_state.rx_max_depth;
+}
+
+uint32_t CAN_get_rx_max_latency(void)
+{
+    return can_state.rx_max_latency;
+}
+
+void CAN_reset_rx_stats(void)
+{
+    __disable_irq();
+    can_state.rx_max_depth = 0;
+    can_state.rx_max_latency = 0;
+    __enable_irq();
+}
+
 CANConfig *CAN_get_config(void)
 {
     return &config;
@@ -195,14 +442,14 @@ void CAN_update(void) {
     if (can_state.send_heartbeat == true)
     {
         const uint32_t msg_diff = msTicks - can_state.last_msg_ms;
-        if (msg_diff >= config.heartbeat_period && PAC55XX_CAN->SR.TBS != 0)
+        if (msg_diff >= config.heartbeat_period)
         {
             can_state.last_msg_ms = msTicks;
             uint32_t proto_hash = _avlos_get_proto_hash();
             uint8_t buf[8];
             memcpy(buf, &proto_hash, sizeof(proto_hash));
             memcpy((buf+sizeof(proto_hash)), GIT_VERSION, 4);
-            can_transmit_extended(sizeof(proto_hash)+4, 0x700 | config.id, buf);
+            CAN_transmit(CAN_TX_PRIORITY_HEARTBEAT, sizeof(proto_hash)+4, 0x700 | config.id, buf);
         }
     }
 }
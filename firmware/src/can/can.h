@@ -17,11 +17,69 @@
 
 #pragma once
 
+// Frames are transmitted highest priority first. Each priority has
+// its own queue, with a length in CAN_TX_QUEUE_LENGTHS.
+typedef enum
+{
+    CAN_TX_PRIORITY_RESPONSE = 0,
+    CAN_TX_PRIORITY_TELEMETRY,
+    CAN_TX_PRIORITY_HEARTBEAT,
+    CAN_TX_PRIORITY_COUNT
+} CANTxPriority;
+
+#define CAN_TX_QUEUE_MAX_LENGTH (8)
+#define CAN_TX_QUEUE_LENGTHS {8, 4, 1}
+
+typedef struct
+{
+    uint32_t id;
+    uint8_t length;
+    uint8_t data[8];
+} CANFrame;
+
+typedef struct
+{
+    CANFrame frames[CAN_TX_QUEUE_MAX_LENGTH];
+    uint8_t head;
+    uint8_t count;
+} CANTxQueue;
+
+// Received frames are queued by the CAN interrupt and processed by the
+// CAN background task, setpoint frames first. Queue lengths in
+// CAN_RX_QUEUE_LENGTHS must be powers of two.
+typedef enum
+{
+    CAN_RX_PRIORITY_SETPOINT = 0,
+    CAN_RX_PRIORITY_OTHER,
+    CAN_RX_PRIORITY_COUNT
+} CANRxPriority;
+
+#define CAN_RX_QUEUE_MAX_LENGTH (16)
+#define CAN_RX_QUEUE_LENGTHS {8, 16}
+
+typedef struct
+{
+    CANFrame frame;
+    uint32_t cycle;     // Control cycle the frame was received in
+    bool rtr;
+    bool extended;
+} CANRxFrame;
+
+// Head and tail are free running, written only by the task and the
+// interrupt respectively
+typedef struct
+{
+    CANRxFrame frames[CAN_RX_QUEUE_MAX_LENGTH];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+} CANRxQueue;
+
 typedef struct 
 {
     uint8_t id;
     uint8_t kbaud_rate;
     uint16_t heartbeat_period;
+    uint8_t broadcast_id;   // Node ID of frames addressed to all nodes, 0 if none
 } CANConfig;
 
 typedef struct 
@@ -29,6 +87,14 @@ typedef struct
     uint8_t faults;
     uint32_t last_msg_ms;
     bool send_heartbeat;
+    uint32_t tx_queued;
+    uint32_t tx_sent;
+    uint32_t tx_dropped;
+    uint32_t rx_accepted;
+    uint32_t rx_rejected;
+    uint32_t rx_overflows;
+    uint8_t rx_max_depth;
+    uint32_t rx_max_latency;
 } CANState;
 
 void CAN_init(void);
@@ -36,7 +102,24 @@ uint16_t CAN_get_kbit_rate(void);
 void CAN_set_kbit_rate(uint16_t rate);
 uint8_t CAN_get_ID(void);
 void CAN_set_ID(uint8_t id);
-void CAN_process_interrupt(void);
+uint8_t CAN_get_broadcast_ID(void);
+void CAN_set_broadcast_ID(uint8_t id);
+void CAN_process_frame(void);
+void CAN_process_rx_interrupt(void);
+void CAN_process_tx_interrupt(void);
+bool CAN_rx_pending(void);
+bool CAN_transmit(CANTxPriority priority, uint8_t length, uint32_t id, const uint8_t *data);
+bool CAN_tx_queue_has_room(CANTxPriority priority);
+
+uint32_t CAN_get_tx_queued(void);
+uint32_t CAN_get_tx_sent(void);
+uint32_t CAN_get_tx_dropped(void);
+uint32_t CAN_get_rx_accepted(void);
+uint32_t CAN_get_rx_rejected(void);
+uint32_t CAN_get_rx_overflows(void);
+uint8_t CAN_get_rx_max_depth(void);
+uint32_t CAN_get_rx_max_latency(void);
+void CAN_reset_rx_stats(void);
 
 bool CAN_get_send_heartbeat(void);
 void CAN_set_send_heartbeat(bool value);
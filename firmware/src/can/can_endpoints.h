@@ -10,8 +10,8 @@
 #include <src/common.h>
 #include <src/tm_enums.h>
 
-static const uint32_t avlos_proto_hash = 3999954334;
-extern uint8_t (*avlos_endpoints[100])(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+static const uint32_t avlos_proto_hash = 640646765;
+extern uint8_t (*avlos_endpoints[181])(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 extern uint32_t _avlos_get_proto_hash(void);
 
 /*
@@ -149,7 +149,7 @@ uint8_t avlos_warnings(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd
 /*
 * avlos_save_config
 *
-* Save configuration to non-volatile memory.
+* Save configuration to non-volatile memory. Completes immediately while the controller is idle, otherwise proceeds in the background.
 *
 * Endpoint ID: 11
 *
@@ -207,431 +207,1223 @@ uint8_t avlos_nvm_current_slot(uint8_t * buffer, uint8_t * buffer_len, Avlos_Com
 uint8_t avlos_nvm_write_count(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_reset
+* avlos_nvm_save_state
 *
-* Reset the device.
+* The state of the config save in progress. While the controller is not idle, saving proceeds in the background, preparing the config and writing it in the idle time of control cycles, and waits for the controller to become idle if flash needs to be erased.
 *
 * Endpoint ID: 16
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_reset(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_nvm_save_state(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_enter_dfu
+* avlos_nvm_save_progress
 *
-* Enter DFU mode.
+* The progress of the config save in progress.
 *
 * Endpoint ID: 17
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_enter_dfu(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_nvm_save_progress(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_config_size
+* avlos_reset
 *
-* Size (in bytes) of the configuration object.
+* Reset the device.
 *
 * Endpoint ID: 18
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_config_size(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_reset(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_scheduler_load
+* avlos_enter_dfu
 *
-* Processor load in ticks per PWM cycle.
+* Enter DFU mode.
 *
 * Endpoint ID: 19
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_scheduler_load(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_enter_dfu(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_scheduler_warnings
+* avlos_config_size
 *
-* Any scheduler warnings, as a bitmask
+* Size (in bytes) of the configuration object.
 *
 * Endpoint ID: 20
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_scheduler_warnings(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_config_size(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_state
+* avlos_scheduler_load
 *
-* The state of the controller.
+* Processor load in ticks per PWM cycle.
 *
 * Endpoint ID: 21
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_state(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_load(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_mode
+* avlos_scheduler_sensor_wait
 *
-* The control mode of the controller.
+* Processor ticks the control loop spent waiting for sensor readings in the last PWM cycle.
 *
 * Endpoint ID: 22
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_mode(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_sensor_wait(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_warnings
+* avlos_scheduler_warnings
 *
-* Any controller warnings, as a bitmask
+* Any scheduler warnings, as a bitmask
 *
 * Endpoint ID: 23
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_warnings(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_warnings(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_errors
+* avlos_scheduler_overruns
 *
-* Any controller errors, as a bitmask
+* Number of control cycles that started before the previous one completed. Wraps around.
 *
 * Endpoint ID: 24
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_errors(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_overruns(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_position_setpoint
+* avlos_scheduler_degradation
 *
-* The position setpoint in the user reference frame.
+* The optional work shed under sustained control loop overruns. Each level also sheds the work of the levels before it.
 *
 * Endpoint ID: 25
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_position_setpoint(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_degradation(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_position_p_gain
+* avlos_scheduler_tasks_can_runs
 *
-* The proportional gain of the position controller.
+* Number of runs of the CAN message handling task. Wraps around.
 *
 * Endpoint ID: 26
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_position_p_gain(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_tasks_can_runs(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_velocity_setpoint
+* avlos_scheduler_tasks_can_cycles
 *
-* The velocity setpoint in the user reference frame.
+* Total processor ticks spent in the CAN message handling task. Wraps around.
 *
 * Endpoint ID: 27
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_velocity_setpoint(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_tasks_can_cycles(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_velocity_limit
+* avlos_scheduler_tasks_can_deferrals
 *
-* The velocity limit.
+* Number of control cycles in which the CAN message handling task was ready but deferred, as it did not fit in the time left. Wraps around.
 *
 * Endpoint ID: 28
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_velocity_limit(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_tasks_can_deferrals(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_velocity_p_gain
+* avlos_scheduler_tasks_uart_runs
 *
-* The proportional gain of the velocity controller.
+* Number of runs of the UART message handling task. Wraps around.
 *
 * Endpoint ID: 29
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_velocity_p_gain(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_tasks_uart_runs(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_velocity_i_gain
+* avlos_scheduler_tasks_uart_cycles
 *
-* The integral gain of the velocity controller.
+* Total processor ticks spent in the UART message handling task. Wraps around.
 *
 * Endpoint ID: 30
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_velocity_i_gain(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_tasks_uart_cycles(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_velocity_deadband
+* avlos_scheduler_tasks_uart_deferrals
 *
-* The deadband of the velocity integrator. A region around the position setpoint where the velocity integrator is not updated.
+* Number of control cycles in which the UART message handling task was ready but deferred, as it did not fit in the time left. Wraps around.
 *
 * Endpoint ID: 31
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_velocity_deadband(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_tasks_uart_deferrals(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_velocity_increment
+* avlos_scheduler_tasks_wwdt_runs
 *
-* Max velocity setpoint increment (ramping) rate. Set to 0 to disable.
+* Number of runs of the watchdog handling task. Wraps around.
 *
 * Endpoint ID: 32
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_velocity_increment(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_tasks_wwdt_runs(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_current_Iq_setpoint
+* avlos_scheduler_tasks_wwdt_cycles
 *
-* The Iq setpoint in the user reference frame.
+* Total processor ticks spent in the watchdog handling task. Wraps around.
 *
 * Endpoint ID: 33
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_current_Iq_setpoint(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_scheduler_tasks_wwdt_cycles(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_current_Id_setpoint
+* avlos_scheduler_tasks_wwdt_deferrals
+*
+* Number of control cycles in which the watchdog handling task was ready but deferred, as it did not fit in the time left. Wraps around.
+*
+* Endpoint ID: 34
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_tasks_wwdt_deferrals(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_tasks_nvm_runs
+*
+* Number of runs of the background config saving task. Wraps around.
+*
+* Endpoint ID: 35
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_tasks_nvm_runs(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_tasks_nvm_cycles
+*
+* Total processor ticks spent in the background config saving task. Wraps around.
+*
+* Endpoint ID: 36
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_tasks_nvm_cycles(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_tasks_nvm_deferrals
+*
+* Number of control cycles in which the background config saving task was ready but deferred, as it did not fit in the time left. Wraps around.
+*
+* Endpoint ID: 37
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_tasks_nvm_deferrals(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_start_max
+*
+* Longest time from the ADC interrupt to the start of the control loop, in processor ticks.
+*
+* Endpoint ID: 38
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_start_max(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_start_bin_0
+*
+* Number of control cycles with 0 to 63 processor ticks from the ADC interrupt to the start of the control loop.
+*
+* Endpoint ID: 39
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_start_bin_0(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_start_bin_1
+*
+* Number of control cycles with 64 to 127 processor ticks from the ADC interrupt to the start of the control loop.
+*
+* Endpoint ID: 40
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_start_bin_1(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_start_bin_2
+*
+* Number of control cycles with 128 to 191 processor ticks from the ADC interrupt to the start of the control loop.
+*
+* Endpoint ID: 41
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_start_bin_2(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_start_bin_3
+*
+* Number of control cycles with 192 to 255 processor ticks from the ADC interrupt to the start of the control loop.
+*
+* Endpoint ID: 42
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_start_bin_3(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_start_bin_4
+*
+* Number of control cycles with 256 to 319 processor ticks from the ADC interrupt to the start of the control loop.
+*
+* Endpoint ID: 43
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_start_bin_4(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_start_bin_5
+*
+* Number of control cycles with 320 to 383 processor ticks from the ADC interrupt to the start of the control loop.
+*
+* Endpoint ID: 44
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_start_bin_5(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_start_bin_6
+*
+* Number of control cycles with 384 to 447 processor ticks from the ADC interrupt to the start of the control loop.
+*
+* Endpoint ID: 45
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_start_bin_6(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_start_bin_7
+*
+* Number of control cycles with 448 processor ticks or more from the ADC interrupt to the start of the control loop.
+*
+* Endpoint ID: 46
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_start_bin_7(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_duty_max
+*
+* Longest time from the ADC interrupt to the duty cycle write, in processor ticks.
+*
+* Endpoint ID: 47
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_duty_max(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_duty_bin_0
+*
+* Number of control cycles with 0 to 1023 processor ticks from the ADC interrupt to the duty cycle write.
+*
+* Endpoint ID: 48
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_duty_bin_0(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_duty_bin_1
+*
+* Number of control cycles with 1024 to 2047 processor ticks from the ADC interrupt to the duty cycle write.
+*
+* Endpoint ID: 49
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_duty_bin_1(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_duty_bin_2
+*
+* Number of control cycles with 2048 to 3071 processor ticks from the ADC interrupt to the duty cycle write.
+*
+* Endpoint ID: 50
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_duty_bin_2(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_duty_bin_3
+*
+* Number of control cycles with 3072 to 4095 processor ticks from the ADC interrupt to the duty cycle write.
+*
+* Endpoint ID: 51
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_duty_bin_3(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_duty_bin_4
+*
+* Number of control cycles with 4096 to 5119 processor ticks from the ADC interrupt to the duty cycle write.
+*
+* Endpoint ID: 52
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_duty_bin_4(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_duty_bin_5
+*
+* Number of control cycles with 5120 to 6143 processor ticks from the ADC interrupt to the duty cycle write.
+*
+* Endpoint ID: 53
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_duty_bin_5(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_duty_bin_6
+*
+* Number of control cycles with 6144 to 7167 processor ticks from the ADC interrupt to the duty cycle write.
+*
+* Endpoint ID: 54
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_duty_bin_6(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_duty_bin_7
+*
+* Number of control cycles with 7168 processor ticks or more from the ADC interrupt to the duty cycle write.
+*
+* Endpoint ID: 55
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_duty_bin_7(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_scheduler_latency_reset
+*
+* Reset the latency histograms and maximums.
+*
+* Endpoint ID: 56
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_scheduler_latency_reset(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_state
+*
+* The state of the controller.
+*
+* Endpoint ID: 57
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_state(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_mode
+*
+* The control mode of the controller.
+*
+* Endpoint ID: 58
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_mode(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_warnings
+*
+* Any controller warnings, as a bitmask
+*
+* Endpoint ID: 59
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_warnings(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_errors
+*
+* Any controller errors, as a bitmask
+*
+* Endpoint ID: 60
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_errors(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_position_setpoint
+*
+* The position setpoint in the user reference frame.
+*
+* Endpoint ID: 61
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_position_setpoint(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_position_set_setpoint_turns
+*
+* Set the position setpoint at full precision, as whole position sensor turns plus a position within the turn in the user reference frame.
+*
+* Endpoint ID: 62
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_position_set_setpoint_turns(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_position_p_gain
+*
+* The proportional gain of the position controller.
+*
+* Endpoint ID: 63
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_position_p_gain(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_velocity_setpoint
+*
+* The velocity setpoint in the user reference frame.
+*
+* Endpoint ID: 64
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_velocity_setpoint(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_velocity_limit
+*
+* The velocity limit.
+*
+* Endpoint ID: 65
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_velocity_limit(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_velocity_p_gain
+*
+* The proportional gain of the velocity controller.
+*
+* Endpoint ID: 66
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_velocity_p_gain(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_velocity_i_gain
+*
+* The integral gain of the velocity controller.
+*
+* Endpoint ID: 67
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_velocity_i_gain(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_velocity_deadband
+*
+* The deadband of the velocity integrator. A region around the position setpoint where the velocity integrator is not updated.
+*
+* Endpoint ID: 68
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_velocity_deadband(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_velocity_increment
+*
+* Max velocity setpoint increment (ramping) rate. Set to 0 to disable.
+*
+* Endpoint ID: 69
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_velocity_increment(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_current_Iq_setpoint
+*
+* The Iq setpoint in the user reference frame.
+*
+* Endpoint ID: 70
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_current_Iq_setpoint(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_current_Id_setpoint
+*
+* The Id setpoint in the user reference frame.
+*
+* Endpoint ID: 71
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_current_Id_setpoint(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_current_Iq_limit
+*
+* The Iq limit.
+*
+* Endpoint ID: 72
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_current_Iq_limit(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_current_Iq_estimate
+*
+* The Iq estimate in the user reference frame.
+*
+* Endpoint ID: 73
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_current_Iq_estimate(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_current_bandwidth
+*
+* The current controller bandwidth.
+*
+* Endpoint ID: 74
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_current_bandwidth(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_current_Iq_p_gain
+*
+* The current controller proportional gain.
+*
+* Endpoint ID: 75
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_current_Iq_p_gain(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_current_max_Ibus_regen
+*
+* The max current allowed to be fed back to the power source before flux braking activates.
+*
+* Endpoint ID: 76
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_current_max_Ibus_regen(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_current_max_Ibrake
+*
+* The max current allowed to be dumped to the motor windings during flux braking. Set to zero to deactivate flux braking.
+*
+* Endpoint ID: 77
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_current_max_Ibrake(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_current_offset_tracking
+*
+* Whether to continuously track current sense offsets while the gate driver is idle or a zero vector is applied.
+*
+* Endpoint ID: 78
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_current_offset_tracking(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_current_offset_tracking_tau
+*
+* The time constant of the continuous current sense offset tracking filter.
+*
+* Endpoint ID: 79
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_current_offset_tracking_tau(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_voltage_Vq_setpoint
+*
+* The Vq setpoint.
+*
+* Endpoint ID: 80
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_voltage_Vq_setpoint(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_voltage_svm_mode
+*
+* The space vector modulation scheme. The discontinuous schemes clamp one phase to a rail at any time, reducing switching losses.
+*
+* Endpoint ID: 81
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_voltage_svm_mode(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_voltage_overmodulation
+*
+* Whether to allow modulation beyond the linear region, up to six-step.
+*
+* Endpoint ID: 82
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_voltage_overmodulation(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_load_estimate
+*
+* The load current estimated by the disturbance observer, in the user reference frame.
+*
+* Endpoint ID: 83
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_load_estimate(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_load_inertia
+*
+* The rotor and load inertia used by the disturbance observer, expressed as current per unit of acceleration in the motor frame.
+*
+* Endpoint ID: 84
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_load_inertia(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_load_bandwidth
+*
+* The disturbance observer bandwidth.
+*
+* Endpoint ID: 85
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_load_bandwidth(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_load_feedforward
+*
+* Whether to feed the load estimate forward into the Iq setpoint in velocity, position and trajectory modes.
+*
+* Endpoint ID: 86
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_load_feedforward(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_latency_compensation
+*
+* Whether to extrapolate the commutation angle over the sensor and PWM output latency.
+*
+* Endpoint ID: 87
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_latency_compensation(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_fusion_enabled
+*
+* Whether to close the velocity loop on the commutation sensor and the position loop on the position sensor, when the two are separate.
+*
+* Endpoint ID: 88
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_fusion_enabled(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_fusion_deflection
+*
+* The difference between the position sensor and commutation sensor positions since entering closed loop control, in the user reference frame.
+*
+* Endpoint ID: 89
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_fusion_deflection(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_fusion_backlash
+*
+* The estimated backlash between the commutation and position sensors, in the user reference frame.
+*
+* Endpoint ID: 90
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_fusion_backlash(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_fusion_compliance
+*
+* The estimated torsional compliance between the commutation and position sensors, as deflection in the user reference frame per ampere of Iq.
+*
+* Endpoint ID: 91
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_fusion_compliance(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_calibration_stages
+*
+* The stages to run at the next calibration. Valid stored results of the other stages are reused. With VERIFY, stored offset, R and L results are first checked with a short measurement, and recalibrated if they do not match. Reverts to all stages once calibration starts.
+*
+* Endpoint ID: 92
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_calibration_stages(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_calibration_mismatch
+*
+* The stored results that failed verification in the last calibration, and were recalibrated.
+*
+* Endpoint ID: 93
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_calibration_mismatch(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_calibration_offset_duration
+*
+* The duration of the current sensor offset stage of the last calibration.
+*
+* Endpoint ID: 94
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_calibration_offset_duration(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_calibration_R_duration
+*
+* The duration of the phase resistance stage of the last calibration.
+*
+* Endpoint ID: 95
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_calibration_R_duration(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_calibration_L_duration
+*
+* The duration of the phase inductance stage of the last calibration.
+*
+* Endpoint ID: 96
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_calibration_L_duration(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_calibration_sensors_duration
+*
+* The duration of the sensor transform and eccentricity stage of the last calibration.
+*
+* Endpoint ID: 97
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_calibration_sensors_duration(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_calibrate
+*
+* Calibrate the device.
+*
+* Endpoint ID: 98
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_calibrate(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_idle
+*
+* Set idle mode, disabling the driver.
+*
+* Endpoint ID: 99
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_controller_idle(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_controller_position_mode
 *
-* The Id setpoint in the user reference frame.
+* Set position control mode.
 *
-* Endpoint ID: 34
+* Endpoint ID: 100
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_current_Id_setpoint(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_controller_position_mode(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_current_Iq_limit
+* avlos_controller_velocity_mode
 *
-* The Iq limit.
+* Set velocity control mode.
 *
-* Endpoint ID: 35
+* Endpoint ID: 101
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_current_Iq_limit(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_controller_velocity_mode(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_current_Iq_estimate
+* avlos_controller_current_mode
 *
-* The Iq estimate in the user reference frame.
+* Set current control mode.
 *
-* Endpoint ID: 36
+* Endpoint ID: 102
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_current_Iq_estimate(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_controller_current_mode(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_current_bandwidth
+* avlos_controller_set_pos_vel_setpoints
 *
-* The current controller bandwidth.
+* Set the position and velocity setpoints in the user reference frame in one go, and retrieve the position estimate
 *
-* Endpoint ID: 37
+* Endpoint ID: 103
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_current_bandwidth(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_controller_set_pos_vel_setpoints(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_current_Iq_p_gain
+* avlos_comms_can_rate
 *
-* The current controller proportional gain.
+* The baud rate of the CAN interface.
 *
-* Endpoint ID: 38
+* Endpoint ID: 104
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_current_Iq_p_gain(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_rate(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_current_max_Ibus_regen
+* avlos_comms_can_id
 *
-* The max current allowed to be fed back to the power source before flux braking activates.
+* The ID of the CAN interface.
 *
-* Endpoint ID: 39
+* Endpoint ID: 105
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_current_max_Ibus_regen(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_id(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_current_max_Ibrake
+* avlos_comms_can_heartbeat
 *
-* The max current allowed to be dumped to the motor windings during flux braking. Set to zero to deactivate flux braking.
+* Toggle sending of heartbeat messages.
 *
-* Endpoint ID: 40
+* Endpoint ID: 106
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_current_max_Ibrake(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_heartbeat(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_voltage_Vq_setpoint
+* avlos_comms_can_broadcast_id
 *
-* The Vq setpoint.
+* The ID that frames addressed to all nodes on the bus are sent to, or 0 for none. Nodes do not respond to these frames.
 *
-* Endpoint ID: 41
+* Endpoint ID: 107
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_voltage_Vq_setpoint(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_broadcast_id(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_calibrate
+* avlos_comms_can_rx_accepted
 *
-* Calibrate the device.
+* Number of received frames addressed to this node or the broadcast ID and processed. Wraps around.
 *
-* Endpoint ID: 42
+* Endpoint ID: 108
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_calibrate(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_rx_accepted(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_idle
+* avlos_comms_can_rx_rejected
 *
-* Set idle mode, disabling the driver.
+* Number of received frames that passed the hardware filters but were discarded, such as standard frames or frames with an unknown endpoint or protocol hash. Frames for other nodes are discarded by the hardware filters and not counted. Wraps around.
 *
-* Endpoint ID: 43
+* Endpoint ID: 109
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_idle(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_rx_rejected(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_position_mode
+* avlos_comms_can_rx_overflows
 *
-* Set position control mode.
+* Number of received frames dropped because their receive queue was full. Wraps around.
 *
-* Endpoint ID: 44
+* Endpoint ID: 110
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_position_mode(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_rx_overflows(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_velocity_mode
+* avlos_comms_can_rx_max_depth
 *
-* Set velocity control mode.
+* Largest number of received frames waiting to be processed.
 *
-* Endpoint ID: 45
+* Endpoint ID: 111
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_velocity_mode(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_rx_max_depth(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_current_mode
+* avlos_comms_can_rx_max_latency
 *
-* Set current control mode.
+* Longest time from receiving a frame to processing it, in control cycles.
 *
-* Endpoint ID: 46
+* Endpoint ID: 112
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_current_mode(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_rx_max_latency(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_controller_set_pos_vel_setpoints
+* avlos_comms_can_reset_rx_stats
 *
-* Set the position and velocity setpoints in the user reference frame in one go, and retrieve the position estimate
+* Reset the largest receive queue depth and latency.
 *
-* Endpoint ID: 47
+* Endpoint ID: 113
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_controller_set_pos_vel_setpoints(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_reset_rx_stats(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_comms_can_rate
+* avlos_comms_can_tx_queued
 *
-* The baud rate of the CAN interface.
+* Number of frames queued for transmission. Wraps around.
 *
-* Endpoint ID: 48
+* Endpoint ID: 114
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_comms_can_rate(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_tx_queued(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_comms_can_id
+* avlos_comms_can_tx_sent
 *
-* The ID of the CAN interface.
+* Number of queued frames written to the CAN controller for transmission. Wraps around.
 *
-* Endpoint ID: 49
+* Endpoint ID: 115
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_comms_can_id(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_tx_sent(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
-* avlos_comms_can_heartbeat
+* avlos_comms_can_tx_dropped
 *
-* Toggle sending of heartbeat messages.
+* Number of frames dropped because their transmit queue was full. Wraps around.
 *
-* Endpoint ID: 50
+* Endpoint ID: 116
 *
 * @param buffer
 * @param buffer_len
 */
-uint8_t avlos_comms_can_heartbeat(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+uint8_t avlos_comms_can_tx_dropped(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
 /*
 * avlos_motor_R
 *
 * The motor Resistance value.
 *
-* Endpoint ID: 51
+* Endpoint ID: 117
 *
 * @param buffer
 * @param buffer_len
@@ -643,7 +1435,7 @@ uint8_t avlos_motor_R(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd)
 *
 * The motor Inductance value.
 *
-* Endpoint ID: 52
+* Endpoint ID: 118
 *
 * @param buffer
 * @param buffer_len
@@ -655,7 +1447,7 @@ uint8_t avlos_motor_L(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd)
 *
 * The motor pole pair count.
 *
-* Endpoint ID: 53
+* Endpoint ID: 119
 *
 * @param buffer
 * @param buffer_len
@@ -667,7 +1459,7 @@ uint8_t avlos_motor_pole_pairs(uint8_t * buffer, uint8_t * buffer_len, Avlos_Com
 *
 * The type of the motor. Either high current or gimbal.
 *
-* Endpoint ID: 54
+* Endpoint ID: 120
 *
 * @param buffer
 * @param buffer_len
@@ -679,7 +1471,7 @@ uint8_t avlos_motor_type(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command c
 *
 * Whether the motor has been calibrated.
 *
-* Endpoint ID: 55
+* Endpoint ID: 121
 *
 * @param buffer
 * @param buffer_len
@@ -691,7 +1483,7 @@ uint8_t avlos_motor_calibrated(uint8_t * buffer, uint8_t * buffer_len, Avlos_Com
 *
 * The calibration current.
 *
-* Endpoint ID: 56
+* Endpoint ID: 122
 *
 * @param buffer
 * @param buffer_len
@@ -703,7 +1495,7 @@ uint8_t avlos_motor_I_cal(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command
 *
 * Any motor/calibration errors, as a bitmask
 *
-* Endpoint ID: 57
+* Endpoint ID: 123
 *
 * @param buffer
 * @param buffer_len
@@ -715,7 +1507,7 @@ uint8_t avlos_motor_errors(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command
 *
 * The filtered position estimate in the user reference frame.
 *
-* Endpoint ID: 58
+* Endpoint ID: 124
 *
 * @param buffer
 * @param buffer_len
@@ -727,19 +1519,43 @@ uint8_t avlos_sensors_user_frame_position_estimate(uint8_t * buffer, uint8_t * b
 *
 * The filtered velocity estimate in the user reference frame.
 *
-* Endpoint ID: 59
+* Endpoint ID: 125
 *
 * @param buffer
 * @param buffer_len
 */
 uint8_t avlos_sensors_user_frame_velocity_estimate(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
+/*
+* avlos_sensors_user_frame_position_turns
+*
+* The whole position sensor turns of the position estimate. Together with position_in_turn it gives the position estimate at full precision, as position_turns * 8192 / multiplier + position_in_turn.
+*
+* Endpoint ID: 126
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_sensors_user_frame_position_turns(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_sensors_user_frame_position_in_turn
+*
+* The position estimate within the current position sensor turn, in the user reference frame.
+*
+* Endpoint ID: 127
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_sensors_user_frame_position_in_turn(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
 /*
 * avlos_sensors_user_frame_offset
 *
 * The user defined offset.
 *
-* Endpoint ID: 60
+* Endpoint ID: 128
 *
 * @param buffer
 * @param buffer_len
@@ -751,7 +1567,7 @@ uint8_t avlos_sensors_user_frame_offset(uint8_t * buffer, uint8_t * buffer_len,
 *
 * The user defined multipler.
 *
-* Endpoint ID: 61
+* Endpoint ID: 129
 *
 * @param buffer
 * @param buffer_len
@@ -763,7 +1579,7 @@ uint8_t avlos_sensors_user_frame_multiplier(uint8_t * buffer, uint8_t * buffer_l
 *
 * Whether the sensor has been calibrated.
 *
-* Endpoint ID: 62
+* Endpoint ID: 130
 *
 * @param buffer
 * @param buffer_len
@@ -775,7 +1591,7 @@ uint8_t avlos_sensors_setup_onboard_calibrated(uint8_t * buffer, uint8_t * buffe
 *
 * Any sensor errors, as a bitmask
 *
-* Endpoint ID: 63
+* Endpoint ID: 131
 *
 * @param buffer
 * @param buffer_len
@@ -787,7 +1603,7 @@ uint8_t avlos_sensors_setup_onboard_errors(uint8_t * buffer, uint8_t * buffer_le
 *
 * The type of the external sensor.
 *
-* Endpoint ID: 64
+* Endpoint ID: 132
 *
 * @param buffer
 * @param buffer_len
@@ -799,19 +1615,31 @@ uint8_t avlos_sensors_setup_external_spi_type(uint8_t * buffer, uint8_t * buffer
 *
 * The rate of the external sensor.
 *
-* Endpoint ID: 65
+* Endpoint ID: 133
 *
 * @param buffer
 * @param buffer_len
 */
 uint8_t avlos_sensors_setup_external_spi_rate(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
+/*
+* avlos_sensors_setup_external_spi_autodetect_rate
+*
+* Probe increasing SPI rates and select the fastest one at which the external sensor reads reliably. Returns whether a reliable rate was found.
+*
+* Endpoint ID: 134
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_sensors_setup_external_spi_autodetect_rate(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
 /*
 * avlos_sensors_setup_external_spi_calibrated
 *
 * Whether the sensor has been calibrated.
 *
-* Endpoint ID: 66
+* Endpoint ID: 135
 *
 * @param buffer
 * @param buffer_len
@@ -823,7 +1651,7 @@ uint8_t avlos_sensors_setup_external_spi_calibrated(uint8_t * buffer, uint8_t *
 *
 * Any sensor errors, as a bitmask
 *
-* Endpoint ID: 67
+* Endpoint ID: 136
 *
 * @param buffer
 * @param buffer_len
@@ -835,7 +1663,7 @@ uint8_t avlos_sensors_setup_external_spi_errors(uint8_t * buffer, uint8_t * buff
 *
 * Whether the sensor has been calibrated.
 *
-* Endpoint ID: 68
+* Endpoint ID: 137
 *
 * @param buffer
 * @param buffer_len
@@ -847,19 +1675,31 @@ uint8_t avlos_sensors_setup_hall_calibrated(uint8_t * buffer, uint8_t * buffer_l
 *
 * Any sensor errors, as a bitmask
 *
-* Endpoint ID: 69
+* Endpoint ID: 138
 *
 * @param buffer
 * @param buffer_len
 */
 uint8_t avlos_sensors_setup_hall_errors(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
+/*
+* avlos_sensors_setup_rectification
+*
+* The eccentricity compensation produced by the next calibration. Either a 64-entry lookup table, or a Fourier series of the first 8 harmonics of the angle error.
+*
+* Endpoint ID: 139
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_sensors_setup_rectification(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
 /*
 * avlos_sensors_select_position_sensor_connection
 *
 * The position sensor connection. Either ONBOARD, EXTERNAL_SPI or HALL.
 *
-* Endpoint ID: 70
+* Endpoint ID: 140
 *
 * @param buffer
 * @param buffer_len
@@ -871,19 +1711,43 @@ uint8_t avlos_sensors_select_position_sensor_connection(uint8_t * buffer, uint8_
 *
 * The position sensor observer bandwidth.
 *
-* Endpoint ID: 71
+* Endpoint ID: 141
 *
 * @param buffer
 * @param buffer_len
 */
 uint8_t avlos_sensors_select_position_sensor_bandwidth(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
+/*
+* avlos_sensors_select_position_sensor_max_accel
+*
+* The maximum acceleration the position observer expects. Readings deviating further from the prediction are rejected as glitches.
+*
+* Endpoint ID: 142
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_sensors_select_position_sensor_max_accel(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_sensors_select_position_sensor_rejected
+*
+* The number of position sensor readings rejected as glitches.
+*
+* Endpoint ID: 143
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_sensors_select_position_sensor_rejected(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
 /*
 * avlos_sensors_select_position_sensor_raw_angle
 *
 * The raw position sensor angle.
 *
-* Endpoint ID: 72
+* Endpoint ID: 144
 *
 * @param buffer
 * @param buffer_len
@@ -895,7 +1759,7 @@ uint8_t avlos_sensors_select_position_sensor_raw_angle(uint8_t * buffer, uint8_t
 *
 * The filtered position estimate in the position sensor reference frame.
 *
-* Endpoint ID: 73
+* Endpoint ID: 145
 *
 * @param buffer
 * @param buffer_len
@@ -907,7 +1771,7 @@ uint8_t avlos_sensors_select_position_sensor_position_estimate(uint8_t * buffer,
 *
 * The filtered velocity estimate in the position sensor reference frame.
 *
-* Endpoint ID: 74
+* Endpoint ID: 146
 *
 * @param buffer
 * @param buffer_len
@@ -919,7 +1783,7 @@ uint8_t avlos_sensors_select_position_sensor_velocity_estimate(uint8_t * buffer,
 *
 * The commutation sensor connection. Either ONBOARD, EXTERNAL_SPI or HALL.
 *
-* Endpoint ID: 75
+* Endpoint ID: 147
 *
 * @param buffer
 * @param buffer_len
@@ -931,19 +1795,55 @@ uint8_t avlos_sensors_select_commutation_sensor_connection(uint8_t * buffer, uin
 *
 * The commutation sensor observer bandwidth.
 *
-* Endpoint ID: 76
+* Endpoint ID: 148
 *
 * @param buffer
 * @param buffer_len
 */
 uint8_t avlos_sensors_select_commutation_sensor_bandwidth(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
+/*
+* avlos_sensors_select_commutation_sensor_max_accel
+*
+* The maximum acceleration the commutation observer expects. Readings deviating further from the prediction are rejected as glitches.
+*
+* Endpoint ID: 149
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_sensors_select_commutation_sensor_max_accel(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_sensors_select_commutation_sensor_rejected
+*
+* The number of commutation sensor readings rejected as glitches.
+*
+* Endpoint ID: 150
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_sensors_select_commutation_sensor_rejected(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_sensors_select_commutation_sensor_latency
+*
+* The age of the commutation sensor reading at the start of each control cycle.
+*
+* Endpoint ID: 151
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_sensors_select_commutation_sensor_latency(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
 /*
 * avlos_sensors_select_commutation_sensor_raw_angle
 *
 * The raw commutation sensor angle.
 *
-* Endpoint ID: 77
+* Endpoint ID: 152
 *
 * @param buffer
 * @param buffer_len
@@ -955,7 +1855,7 @@ uint8_t avlos_sensors_select_commutation_sensor_raw_angle(uint8_t * buffer, uint
 *
 * The filtered position estimate in the commutation sensor reference frame.
 *
-* Endpoint ID: 78
+* Endpoint ID: 153
 *
 * @param buffer
 * @param buffer_len
@@ -967,7 +1867,7 @@ uint8_t avlos_sensors_select_commutation_sensor_position_estimate(uint8_t * buff
 *
 * The filtered velocity estimate in the commutation sensor reference frame.
 *
-* Endpoint ID: 79
+* Endpoint ID: 154
 *
 * @param buffer
 * @param buffer_len
@@ -979,7 +1879,7 @@ uint8_t avlos_sensors_select_commutation_sensor_velocity_estimate(uint8_t * buff
 *
 * The max allowed acceleration of the generated trajectory.
 *
-* Endpoint ID: 80
+* Endpoint ID: 155
 *
 * @param buffer
 * @param buffer_len
@@ -991,7 +1891,7 @@ uint8_t avlos_traj_planner_max_accel(uint8_t * buffer, uint8_t * buffer_len, Avl
 *
 * The max allowed deceleration of the generated trajectory.
 *
-* Endpoint ID: 81
+* Endpoint ID: 156
 *
 * @param buffer
 * @param buffer_len
@@ -1003,7 +1903,7 @@ uint8_t avlos_traj_planner_max_decel(uint8_t * buffer, uint8_t * buffer_len, Avl
 *
 * The max allowed cruise velocity of the generated trajectory.
 *
-* Endpoint ID: 82
+* Endpoint ID: 157
 *
 * @param buffer
 * @param buffer_len
@@ -1015,7 +1915,7 @@ uint8_t avlos_traj_planner_max_vel(uint8_t * buffer, uint8_t * buffer_len, Avlos
 *
 * In time mode, the acceleration time of the generated trajectory.
 *
-* Endpoint ID: 83
+* Endpoint ID: 158
 *
 * @param buffer
 * @param buffer_len
@@ -1027,7 +1927,7 @@ uint8_t avlos_traj_planner_t_accel(uint8_t * buffer, uint8_t * buffer_len, Avlos
 *
 * In time mode, the deceleration time of the generated trajectory.
 *
-* Endpoint ID: 84
+* Endpoint ID: 159
 *
 * @param buffer
 * @param buffer_len
@@ -1039,7 +1939,7 @@ uint8_t avlos_traj_planner_t_decel(uint8_t * buffer, uint8_t * buffer_len, Avlos
 *
 * In time mode, the total time of the generated trajectory.
 *
-* Endpoint ID: 85
+* Endpoint ID: 160
 *
 * @param buffer
 * @param buffer_len
@@ -1051,43 +1951,115 @@ uint8_t avlos_traj_planner_t_total(uint8_t * buffer, uint8_t * buffer_len, Avlos
 *
 * Move to target position in the user reference frame respecting velocity and acceleration limits.
 *
-* Endpoint ID: 86
+* Endpoint ID: 161
 *
 * @param buffer
 * @param buffer_len
 */
 uint8_t avlos_traj_planner_move_to(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
+/*
+* avlos_traj_planner_move_to_turns
+*
+* Move to a target position given at full precision, as whole position sensor turns plus a position within the turn in the user reference frame, respecting velocity and acceleration limits.
+*
+* Endpoint ID: 162
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_traj_planner_move_to_turns(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
 /*
 * avlos_traj_planner_move_to_tlimit
 *
 * Move to target position in the user reference frame respecting time limits for each sector.
 *
-* Endpoint ID: 87
+* Endpoint ID: 163
 *
 * @param buffer
 * @param buffer_len
 */
 uint8_t avlos_traj_planner_move_to_tlimit(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
+/*
+* avlos_traj_planner_move_to_turns_tlimit
+*
+* Move to a target position given at full precision, as whole position sensor turns plus a position within the turn in the user reference frame, respecting time limits for each sector.
+*
+* Endpoint ID: 164
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_traj_planner_move_to_turns_tlimit(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
 /*
 * avlos_traj_planner_errors
 *
 * Any errors in the trajectory planner, as a bitmask
 *
-* Endpoint ID: 88
+* Endpoint ID: 165
 *
 * @param buffer
 * @param buffer_len
 */
 uint8_t avlos_traj_planner_errors(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
 
+/*
+* avlos_traj_planner_shaper_type
+*
+* The input shaper applied to generated trajectories. Either NONE, ZV or ZVD.
+*
+* Endpoint ID: 166
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_traj_planner_shaper_type(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_traj_planner_shaper_frequency
+*
+* The resonant frequency of the axis that the input shaper cancels.
+*
+* Endpoint ID: 167
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_traj_planner_shaper_frequency(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_traj_planner_shaper_damping
+*
+* The damping ratio of the resonance that the input shaper cancels.
+*
+* Endpoint ID: 168
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_traj_planner_shaper_damping(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
+/*
+* avlos_traj_planner_shaper_delay
+*
+* The delay added to the end of each trajectory by the input shaper.
+*
+* Endpoint ID: 169
+*
+* @param buffer
+* @param buffer_len
+*/
+uint8_t avlos_traj_planner_shaper_delay(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command cmd);
+
 /*
 * avlos_homing_velocity
 *
 * The velocity at which the motor performs homing.
 *
-* Endpoint ID: 89
+* Endpoint ID: 170
 *
 * @param buffer
 * @param buffer_len
@@ -1099,7 +2071,7 @@ uint8_t avlos_homing_velocity(uint8_t * buffer, uint8_t * buffer_len, Avlos_Comm
 *
 * The maximum time the motor is allowed to travel before homing times out and aborts.
 *
-* Endpoint ID: 90
+* Endpoint ID: 171
 *
 * @param buffer
 * @param buffer_len
@@ -1111,7 +2083,7 @@ uint8_t avlos_homing_max_homing_t(uint8_t * buffer, uint8_t * buffer_len, Avlos_
 *
 * The retraction distance the motor travels after the endstop has been found.
 *
-* Endpoint ID: 91
+* Endpoint ID: 172
 *
 * @param buffer
 * @param buffer_len
@@ -1123,7 +2095,7 @@ uint8_t avlos_homing_retract_dist(uint8_t * buffer, uint8_t * buffer_len, Avlos_
 *
 * Any homing warnings, as a bitmask
 *
-* Endpoint ID: 92
+* Endpoint ID: 173
 *
 * @param buffer
 * @param buffer_len
@@ -1135,7 +2107,7 @@ uint8_t avlos_homing_warnings(uint8_t * buffer, uint8_t * buffer_len, Avlos_Comm
 *
 * The velocity below which (and together with `stall_detect.delta_pos`) stall detection mode is triggered.
 *
-* Endpoint ID: 93
+* Endpoint ID: 174
 *
 * @param buffer
 * @param buffer_len
@@ -1147,7 +2119,7 @@ uint8_t avlos_homing_stall_detect_velocity(uint8_t * buffer, uint8_t * buffer_le
 *
 * The velocity below which (and together with `stall_detect.delta_pos`) stall detection mode is triggered.
 *
-* Endpoint ID: 94
+* Endpoint ID: 175
 *
 * @param buffer
 * @param buffer_len
@@ -1159,7 +2131,7 @@ uint8_t avlos_homing_stall_detect_delta_pos(uint8_t * buffer, uint8_t * buffer_l
 *
 * The time to remain in stall detection mode before the motor is considered stalled.
 *
-* Endpoint ID: 95
+* Endpoint ID: 176
 *
 * @param buffer
 * @param buffer_len
@@ -1171,7 +2143,7 @@ uint8_t avlos_homing_stall_detect_t(uint8_t * buffer, uint8_t * buffer_len, Avlo
 *
 * Perform the homing operation.
 *
-* Endpoint ID: 96
+* Endpoint ID: 177
 *
 * @param buffer
 * @param buffer_len
@@ -1183,7 +2155,7 @@ uint8_t avlos_homing_home(uint8_t * buffer, uint8_t * buffer_len, Avlos_Command
 *
 * Whether the watchdog is enabled or not.
 *
-* Endpoint ID: 97
+* Endpoint ID: 178
 *
 * @param buffer
 * @param buffer_len
@@ -1195,7 +2167,7 @@ uint8_t avlos_watchdog_enabled(uint8_t * buffer, uint8_t * buffer_len, Avlos_Com
 *
 * Whether the watchdog has been triggered or not.
 *
-* Endpoint ID: 98
+* Endpoint ID: 179
 *
 * @param buffer
 * @param buffer_len
@@ -1207,7 +2179,7 @@ uint8_t avlos_watchdog_triggered(uint8_t * buffer, uint8_t * buffer_len, Avlos_C
 *
 * The watchdog timeout period.
 *
-* Endpoint ID: 99
+* Endpoint ID: 180
 *
 * @param buffer
 * @param buffer_len
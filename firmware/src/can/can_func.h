@@ -136,11 +136,25 @@ static inline void can_process_standard(void)
 //  * You should have received a copy of the GNU General Public License
 //  * along with this program. If not, see <http://www.gnu.org/licenses/>.
 
-static inline void can_process_extended(void)
+// Returns false for standard frames, which are read out of the RX
+// buffer but not decoded
+static inline bool can_process_extended(void)
 {
     uint32_t buffer = PAC55XX_CAN->RXBUF; //  read RX buffer, RX buffer bit order same as TX buffer
 
     data_length = buffer & 0x0F;
+    if (((buffer >> 7) & 0x1) == 0)
+    {
+        if (data_length > 1u)
+        {
+            buffer = PAC55XX_CAN->RXBUF;
+            if (data_length > 5u)
+            {
+                buffer = PAC55XX_CAN->RXBUF;
+            }
+        }
+        return false;
+    }
     rtr = ((buffer >> 6) & 0x1) == 0x1;
     rx_id = ((buffer & 0xFF000000) >> 19) | ((buffer & 0x00FF0000) >> 3) | ((buffer & 0x0000FF00) << 13);
     
@@ -166,6 +180,7 @@ static inline void can_process_extended(void)
             rx_data[7] = buffer & 0xFF;
         }
     }
+    return true;
 }
 
 static inline void can_transmit_standard(uint8_t dataLen, uint16_t id, const uint8_t * data)
@@ -160,4 +160,13 @@ typedef struct
 
 static const FloatTriplet three_phase_zero = {0.5f, 0.5f, 0.5f};
 
+// Position as whole sensor turns plus ticks within the turn, in
+// [0, SENSOR_COMMON_RES_TICKS). Unlike a single float, resolution
+// does not degrade with the distance travelled.
+typedef struct
+{
+	int32_t turns;
+	float ticks;
+} TurnPosition;
+
 #endif // #ifndef COMMON_H
@@ -40,10 +40,47 @@
 #define I_HARD_LIMIT                (60.0f)    // A
 #define MAX_CL_INIT_STEPS           (200)
 #define PRE_CL_I_SD_MAX            (0.4f)
+// Duties computed in a cycle are loaded at the next period and act
+// around its center, one period after the currents were sampled
+#define PWM_OUTPUT_DELAY_S          (1.0f / PWM_FREQ_HZ)
+
+// Observer innovation gating
+#define OBSERVER_DEFAULT_MAX_ACCEL  (2.0e7f)  // ticks/s^2
+#define OBSERVER_GATE_MIN_TICKS     (256.0f)  // Allowance for sensor noise
+#define OBSERVER_MAX_COAST_CYCLES   (8)
+#define OBSERVER_LOCK_CYCLES        (PWM_FREQ_HZ / 20) // Tracking time before gating applies
+
+// Dual encoder deflection estimation
+#define DEFLECTION_MIN_I            (0.1f)    // A, no estimation while torque is this close to reversing
+#define DEFLECTION_WINDOW_S         (2.0f)    // Time constant of the forgetting factor
+#define DEFLECTION_P_INIT           (1.0e6f)
+#define DEFLECTION_P_MAX            (1.0e8f)  // Covariance bound against windup without excitation
+
+// Calibration stages end early once their estimate converges
+#define CONVERGENCE_BLOCKS          (4)
+#define CAL_CONV_BLOCK_LEN          (PWM_FREQ_HZ / 20)
+#define CAL_CONV_REL_TOL            (0.002f)  // Relative to the estimate
+#define CAL_OFFSET_TOL              (0.002f)  // A
+#define CAL_OFFSET_MAX_LEN          (PWM_FREQ_HZ / 2)
+
+// Verification of stored calibration results
+#define CAL_VERIFY_LEN              (PWM_FREQ_HZ / 10)
+#define CAL_VERIFY_OFFSET_TOL       (0.05f)   // A
+#define CAL_VERIFY_REL_TOL          (0.2f)    // Resistance drifts by ~0.4%/K with winding temperature
+
+// Optional work is shed one level at a time under sustained control
+// loop overruns, and restored one level at a time once they stop
+#define OVERRUN_WINDOW_CYCLES       (PWM_FREQ_HZ / 100)  // 10ms
+#define OVERRUN_SHED_LIMIT          (2)       // Overruns in a window that shed the next level
+#define OVERRUN_RESTORE_WINDOWS     (100)     // Windows without overruns that restore a level
+#define SHED_TEMP_DECIMATION        (20)
+#define SHED_TRAJ_DECIMATION        (2)
 
 // Encoder rectification lookup table size
 #define ECN_BITS (6)
 #define ECN_SIZE (1 << ECN_BITS)
+// Number of harmonics in the alternative Fourier series rectification
+#define ECN_HARMONICS (8)
 
 // UART
 #define UART_ENUM UARTB
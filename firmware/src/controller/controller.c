@@ -27,11 +27,20 @@
 #include <src/controller/controller.h>
 #include "src/watchdog/watchdog.h"
 
+extern volatile uint32_t msTicks;
+
 void CLPreStep(void);
 void CLPreCheck(void);
+void CalibrationSequence(void);
+static bool CalibrationStageNeeded(uint8_t stages, uint8_t stage, bool valid, bool (*verify)(void));
+static inline bool CalibrationSensorsValid(void);
 void CLControlStep(void);
 static inline bool Controller_LimitVelocity(float min_limit, float max_limit, float vel_estimate,
                                                             float vel_gain, float *I);
+static inline bool Controller_FusionActive(void);
+static inline float Controller_GetVelEstimateMotorFrame(void);
+static inline void Controller_ResetDeflection(void);
+static inline void Controller_UpdateDeflection(float Iq);
 
 static MotionPlan motion_plan;
 static ControllerState state = {
@@ -50,7 +59,7 @@ static ControllerState state = {
     .Ibus_est = 0.0f,
     .power_est = 0.0f,
 
-    .pos_setpoint = 0.0f,
+    .pos_setpoint = {0, 0.0f},
     .vel_setpoint = 0.0f,
     .vel_ramp_setpoint  = 0.0f,
     .Iq_setpoint = 0.0f,
@@ -63,7 +72,12 @@ static ControllerState state = {
     .Iq_integrator = 0.0f,
     .Id_integrator = 0.0f,
 
-    .t_plan = 0.0f
+    .I_load_estimate = 0.0f,
+    .vel_prev = 0.0f,
+
+    .t_plan = 0.0f,
+
+    .cal_stages = CAL_STAGES_ALL
 };
 
 Statistics pre_cl_stats = {0};
@@ -84,7 +98,15 @@ static ControllerConfig config = {
     .I_k = 0.3f,
     .vel_increment = 100.0f, // ticks/cycle
     .max_Ibus_regen = 0.0f,
-    .max_Ibrake = 0.0f}; 
+    .max_Ibrake = 0.0f,
+    .load_inertia = 0.0f,
+    .load_bw = 20.0f,
+    .load_D = 0.0f,
+    .load_feedforward = false,
+    .svm_mode = CONTROLLER_VOLTAGE_SVM_MODE_CONTINUOUS,
+    .overmodulation = false,
+    .latency_compensation = true,
+    .fusion = false};
 
 #elif defined BOARD_REV_M5
 
@@ -102,12 +124,21 @@ static ControllerConfig config = {
     .I_k = 0.3f,
     .vel_increment = 100.0f, // ticks/cycle
     .max_Ibus_regen = 0.0f,
-    .max_Ibrake = 0.0f}; 
+    .max_Ibrake = 0.0f,
+    .load_inertia = 0.0f,
+    .load_bw = 20.0f,
+    .load_D = 0.0f,
+    .load_feedforward = false,
+    .svm_mode = CONTROLLER_VOLTAGE_SVM_MODE_CONTINUOUS,
+    .overmodulation = false,
+    .latency_compensation = true,
+    .fusion = false};
 
 #endif
 
 void Controller_ControlLoop(void)
 {
+    controller_update_load_gains();
     while (true)
     {
         state.warnings = 0;
@@ -125,12 +156,7 @@ void Controller_ControlLoop(void)
         if (state.state == CONTROLLER_STATE_CALIBRATE)
         {
             state.is_calibrating = true;
-            system_reset_calibration();
-            // TODO: sensors_calibrate should also return bool, and be integrated in the calibration sequence
-            if (ADC_calibrate_offset() && motor_calibrate_resistance() && motor_calibrate_inductance())
-            {
-                (void)(sensors_calibrate());
-            }
+            CalibrationSequence();
             state.is_calibrating = false;
             controller_set_state(CONTROLLER_STATE_IDLE); 
         }
@@ -148,7 +174,7 @@ void Controller_ControlLoop(void)
             }
             else if ((motor_get_is_gimbal() == false) && pre_cl_stats.size == MAX_CL_INIT_STEPS)
             {
-                state.pos_setpoint = observer_get_pos_estimate(&position_observer);
+                state.pos_setpoint = *observer_get_turn_position(&position_observer);
                 CLPreStep();
                 CLPreCheck();
             }
@@ -161,6 +187,101 @@ void Controller_ControlLoop(void)
     }
 }
 
+// Runs the requested calibration stages in sequence, timing each of
+// them. Stages that were not requested reuse their stored results,
+// unless these are invalid or fail verification.
+void CalibrationSequence(void)
+{
+    const uint8_t stages = state.cal_stages;
+    state.cal_stages = CAL_STAGES_ALL;
+    state.cal_mismatch = CONTROLLER_CALIBRATION_MISMATCH_NONE;
+    CalibrationDurations *d = &(state.cal_durations);
+    *d = (CalibrationDurations){0};
+    bool ok = true;
+
+    uint32_t t_start = msTicks;
+    if (CalibrationStageNeeded(stages, CONTROLLER_CALIBRATION_STAGES_OFFSET,
+        ADC_get_offset_calibrated(), ADC_verify_offset))
+    {
+        ADC_reset();
+        ok = ADC_calibrate_offset();
+    }
+    d->offset = (msTicks - t_start) * 0.001f;
+    if (!ok)
+    {
+        return;
+    }
+
+    t_start = msTicks;
+    if (CalibrationStageNeeded(stages, CONTROLLER_CALIBRATION_STAGES_R,
+        motor_get_resistance_calibrated(), motor_verify_resistance))
+    {
+        motor_reset_resistance();
+        ok = motor_calibrate_resistance();
+    }
+    d->R = (msTicks - t_start) * 0.001f;
+    if (!ok)
+    {
+        return;
+    }
+
+    t_start = msTicks;
+    if (CalibrationStageNeeded(stages, CONTROLLER_CALIBRATION_STAGES_L,
+        motor_get_inductance_calibrated(), motor_verify_inductance))
+    {
+        motor_reset_inductance();
+        ok = motor_calibrate_inductance();
+    }
+    d->L = (msTicks - t_start) * 0.001f;
+    if (!ok)
+    {
+        return;
+    }
+
+    // There is no quick check of the sensor results, as they span a
+    // full turn of the motor
+    t_start = msTicks;
+    if (CalibrationStageNeeded(stages, CONTROLLER_CALIBRATION_STAGES_SENSORS,
+        CalibrationSensorsValid(), NULL))
+    {
+        sensors_reset();
+        observers_init_with_defaults();
+        motor_reset_pole_pairs();
+        wait_pwm_cycles(5000);
+        ok = sensors_calibrate();
+    }
+    d->sensors = (msTicks - t_start) * 0.001f;
+    if (!ok)
+    {
+        return;
+    }
+}
+
+// Whether a calibration stage needs to run, because it was requested,
+// its stored result is not valid, or verification of the stored result
+// was requested and failed.
+static bool CalibrationStageNeeded(uint8_t stages, uint8_t stage, bool valid, bool (*verify)(void))
+{
+    if ((stages & stage) || !valid)
+    {
+        return true;
+    }
+    if ((stages & CONTROLLER_CALIBRATION_STAGES_VERIFY) && verify && !verify())
+    {
+        // Mismatch flags share the bit positions of their stages
+        state.cal_mismatch |= stage;
+        return true;
+    }
+    return false;
+}
+
+static inline bool CalibrationSensorsValid(void)
+{
+    return frames_get_calibrated() && motor_get_poles_calibrated()
+        && commutation_sensor_p->is_calibrated_func(commutation_sensor_p)
+        && position_sensor_p->is_calibrated_func(position_sensor_p);
+}
+
 TM_RAMFUNC void CLPreStep(void)
 {
     gate_driver_set_duty_cycle(&three_phase_zero);
@@ -183,8 +304,14 @@ TM_RAMFUNC void CLControlStep(void)
     {
         case CONTROLLER_MODE_TRAJECTORY:
         state.t_plan += PWM_PERIOD_S;
+        if (scheduler_sheds(SCHEDULER_DEGRADATION_TRAJECTORY) && !traj_planner_is_shaped()
+            && (scheduler_state.cycle % SHED_TRAJ_DECIMATION != 0))
+        {
+            // Under overload, the setpoint is extrapolated between evaluations
+            turn_position_add(&state.pos_setpoint, state.vel_setpoint * PWM_PERIOD_S);
+        }
         // This will set state.pos_setpoint state.vel_setpoint (in user frame)
-        if (!traj_planner_evaluate(state.t_plan, &motion_plan))
+        else if (!traj_planner_evaluate(state.t_plan, &motion_plan))
         {
             // Drop to position mode on error or completion
             controller_set_mode(CONTROLLER_MODE_POSITION);
@@ -222,13 +349,18 @@ TM_RAMFUNC void CLControlStep(void)
 
     if (state.mode >= CONTROLLER_MODE_POSITION)
     {
-        const float delta_pos = get_diff_position_sensor_frame(state.pos_setpoint);
+        const float delta_pos = get_diff_position_sensor_frame(&state.pos_setpoint);
         const float delta_pos_integral = sgnf(delta_pos) * our_fmaxf(0, fabsf(delta_pos) - config.vel_integral_deadband);
         vel_setpoint += delta_pos * config.pos_gain;
         vel_setpoint_integral += delta_pos_integral * config.pos_gain;
     }
 
-    const float vel_estimate = observer_get_vel_estimate(&position_observer);
+    // With fusion, the velocity loop closes on the motor side sensor
+    // while the position loop keeps closing on the output side sensor
+    const bool fusion = Controller_FusionActive();
+    const float vel_estimate_motor_frame = Controller_GetVelEstimateMotorFrame();
+    const float vel_estimate = fusion ? apply_velocity_transform(vel_estimate_motor_frame, frame_motor_to_position_sensor_p())
+        : observer_get_vel_estimate(&position_observer);
     float Iq_setpoint = state.Iq_setpoint;
 
     if (state.mode >= CONTROLLER_MODE_VELOCITY) 
@@ -243,8 +375,14 @@ TM_RAMFUNC void CLControlStep(void)
         state.vel_integrator = 0.0f;
     }
 
+    // Load torque compensation, using the disturbance observer
+    // estimate from the previous cycle
+    if ((state.mode >= CONTROLLER_MODE_VELOCITY) && (config.load_feedforward == true))
+    {
+        Iq_setpoint += state.I_load_estimate;
+    }
+
     // Velocity-dependent current limiting
-    const float vel_estimate_motor_frame = apply_velocity_transform(vel_estimate, frame_position_sensor_to_motor_p());
     if (Controller_LimitVelocity(-config.vel_limit, config.vel_limit, vel_estimate_motor_frame, config.vel_gain, &Iq_setpoint) == true)
     {
         state.vel_integrator *= 0.995f;
@@ -270,9 +408,18 @@ TM_RAMFUNC void CLControlStep(void)
         state.Id_setpoint = 0.0f;
     }
 
-    const float e_phase = observer_get_epos_motor_frame();
-    const float c_I = fast_cos(e_phase);
-    const float s_I = fast_sin(e_phase);
+    // Rotor angle at the time the currents were sampled, and at the
+    // time the computed voltage will be applied
+    float e_phase_I = observer_get_epos_motor_frame();
+    float e_phase_V = e_phase_I;
+    if (config.latency_compensation)
+    {
+        e_phase_I = observer_get_epos_motor_frame_ahead(0.0f);
+        e_phase_V = observer_get_epos_motor_frame_ahead(PWM_OUTPUT_DELAY_S);
+    }
+    float c_I;
+    float s_I;
+    fast_sincos(e_phase_I, &s_I, &c_I);
 
     float Vd;
     float Vq;
@@ -307,6 +454,19 @@ TM_RAMFUNC void CLControlStep(void)
         Vq = (delta_Iq * config.I_gain) + state.Iq_integrator;
     }
     state.Vq_setpoint = Vq;
+
+    // Disturbance observer: the current not accounted for by
+    // accelerating the configured inertia is attributed to the load.
+    // Gimbal motors have no current measurement, so the setpoint is used.
+    const float Iq_applied = motor_get_is_gimbal() ? Iq_setpoint : state.Iq_estimate;
+    const float I_inertia = config.load_inertia * (vel_estimate_motor_frame - state.vel_prev) * PWM_FREQ_HZ;
+    state.I_load_estimate += config.load_D * (Iq_applied - I_inertia - state.I_load_estimate);
+    state.vel_prev = vel_estimate_motor_frame;
+
+    if (fusion)
+    {
+        Controller_UpdateDeflection(Iq_applied);
+    }
     
     float mod_q = Vq * one_over_Vbus_voltage;
     float mod_d = Vd * one_over_Vbus_voltage;
@@ -314,7 +474,8 @@ TM_RAMFUNC void CLControlStep(void)
     state.power_est = state.Ibus_est * Vbus_voltage;
 
     // dq modulation limiter
-    const float dq_mod_scale_factor = PWM_LIMIT * fast_inv_sqrt((mod_q * mod_q) + (mod_d * mod_d));
+    const float mod_limit = config.overmodulation ? SVM_SIXSTEP_LIMIT : PWM_LIMIT;
+    const float dq_mod_scale_factor = mod_limit * fast_inv_sqrt((mod_q * mod_q) + (mod_d * mod_d));
 
     if (dq_mod_scale_factor < 1.0f)
     {
@@ -326,12 +487,34 @@ TM_RAMFUNC void CLControlStep(void)
     }
 
     // Inverse Park transform
-    const float mod_a = (c_I * mod_d) - (s_I * mod_q);
-    const float mod_b = (c_I * mod_q) + (s_I * mod_d);
+    float c_V;
+    float s_V;
+    fast_sincos(e_phase_V, &s_V, &c_V);
+    const float mod_a = (c_V * mod_d) - (s_V * mod_q);
+    const float mod_b = (c_V * mod_q) + (s_V * mod_d);
 
-    SVM(mod_a, mod_b, &state.modulation_values.A,
-        &state.modulation_values.B, &state.modulation_values.C);
+    if (config.overmodulation)
+    {
+        SVM_overmodulation(mod_a, mod_b, &state.modulation_values.A,
+            &state.modulation_values.B, &state.modulation_values.C);
+    }
+    else
+    {
+        SVM(mod_a, mod_b, &state.modulation_values.A,
+            &state.modulation_values.B, &state.modulation_values.C);
+    }
+    if (config.svm_mode == CONTROLLER_VOLTAGE_SVM_MODE_DPWMMIN)
+    {
+        SVM_clamp_min(&state.modulation_values.A,
+            &state.modulation_values.B, &state.modulation_values.C);
+    }
+    else if (config.svm_mode == CONTROLLER_VOLTAGE_SVM_MODE_DPWM1)
+    {
+        SVM_clamp_peak(&state.modulation_values.A,
+            &state.modulation_values.B, &state.modulation_values.C);
+    }
     gate_driver_set_duty_cycle(&state.modulation_values);
+    scheduler_record_duty_latency();
 }
 
 
@@ -347,6 +530,9 @@ TM_RAMFUNC void controller_set_state(controller_state_options new_state)
         if ((new_state == CONTROLLER_STATE_CL_CONTROL) && (state.state == CONTROLLER_STATE_IDLE) && (!errors_exist()) && motor_get_calibrated())
         {
             gate_driver_enable();
+            state.I_load_estimate = 0.0f;
+            state.vel_prev = Controller_GetVelEstimateMotorFrame();
+            Controller_ResetDeflection();
             state.state = CONTROLLER_STATE_CL_CONTROL;
         }
         else if ((new_state == CONTROLLER_STATE_CALIBRATE) && (state.state == CONTROLLER_STATE_IDLE) && (!errors_exist()))
@@ -356,6 +542,7 @@ TM_RAMFUNC void controller_set_state(controller_state_options new_state)
         }
         else // state != CONTROLLER_STATE_IDLE --> Got to idle state anyway
         {
+            state.modulation_values = three_phase_zero;
             gate_driver_set_duty_cycle(&three_phase_zero);
             gate_driver_disable();
             memset(&pre_cl_stats, 0, sizeof(pre_cl_stats));
@@ -408,7 +595,7 @@ TM_RAMFUNC float controller_get_Iq_estimate_user_frame(void)
 
 TM_RAMFUNC float controller_get_pos_setpoint_user_frame(void)
 {
-    return apply_transform(state.pos_setpoint, frame_position_sensor_to_user_p());
+    return apply_transform(turn_position_to_ticks(&state.pos_setpoint), frame_position_sensor_to_user_p());
 }
 
 TM_RAMFUNC float controller_get_vel_setpoint_user_frame(void)
@@ -420,6 +607,13 @@ TM_RAMFUNC float controller_get_Iq_estimate(void)
 {
     return state.Iq_estimate;
 }
+TM_RAMFUNC void controller_get_modulation_values(FloatTriplet *dc)
+{
+    dc->A = state.modulation_values.A;
+    dc->B = state.modulation_values.B;
+    dc->C = state.modulation_values.C;
+}
+
 TM_RAMFUNC float controller_get_Iq_setpoint_user_frame(void)
 {
     return apply_velocity_transform(state.Iq_setpoint, frame_motor_to_user_p());
@@ -432,7 +626,28 @@ TM_RAMFUNC float controller_get_Id_setpoint_user_frame(void)
 
 TM_RAMFUNC void controller_set_pos_setpoint_user_frame(float value)
 {
-    state.pos_setpoint = apply_transform(value, frame_user_to_position_sensor_p());
+    TurnPosition pos_setpoint;
+    turn_position_from_ticks(&pos_setpoint, apply_transform(value, frame_user_to_position_sensor_p()));
+    state.pos_setpoint = pos_setpoint;
+}
+
+void controller_set_pos_setpoint_turns_user_frame(int32_t turns, float in_turn)
+{
+    TurnPosition pos_setpoint = {.turns = turns, .ticks = 0.0f};
+    turn_position_add(&pos_setpoint, apply_transform(in_turn, frame_user_to_position_sensor_p()));
+    state.pos_setpoint = pos_setpoint;
+}
+
+TM_RAMFUNC void controller_set_pos_setpoint_relative_user_frame(const TurnPosition *origin, float offset)
+{
+    TurnPosition pos_setpoint = *origin;
+    turn_position_add(&pos_setpoint, apply_velocity_transform(offset, frame_user_to_position_sensor_p()));
+    state.pos_setpoint = pos_setpoint;
+}
+
+TM_RAMFUNC void controller_get_pos_setpoint(TurnPosition *pos)
+{
+    *pos = state.pos_setpoint;
 }
 
 TM_RAMFUNC void controller_set_vel_setpoint_user_frame(float value)
@@ -603,6 +818,147 @@ void controller_set_max_Ibrake(float value)
     }
 }
 
+TM_RAMFUNC float controller_get_I_load_estimate(void)
+{
+    return state.I_load_estimate;
+}
+
+float controller_get_I_load_estimate_user_frame(void)
+{
+    return apply_velocity_transform(state.I_load_estimate, frame_motor_to_user_p());
+}
+
+float controller_get_load_inertia(void)
+{
+    return config.load_inertia;
+}
+
+void controller_set_load_inertia(float value)
+{
+    if (value >= 0.0f)
+    {
+        config.load_inertia = value;
+    }
+}
+
+float controller_get_load_bw(void)
+{
+    return config.load_bw;
+}
+
+void controller_set_load_bw(float bw)
+{
+    if (bw > 0.0f)
+    {
+        config.load_bw = bw;
+        controller_update_load_gains();
+    }
+}
+
+bool controller_get_load_feedforward(void)
+{
+    return config.load_feedforward;
+}
+
+void controller_set_load_feedforward(bool enabled)
+{
+    config.load_feedforward = enabled;
+}
+
+controller_voltage_svm_mode_options controller_get_svm_mode(void)
+{
+    return config.svm_mode;
+}
+
+void controller_set_svm_mode(controller_voltage_svm_mode_options mode)
+{
+    if (mode < CONTROLLER_VOLTAGE_SVM_MODE__MAX)
+    {
+        config.svm_mode = mode;
+    }
+}
+
+bool controller_get_overmodulation(void)
+{
+    return config.overmodulation;
+}
+
+void controller_set_overmodulation(bool enabled)
+{
+    config.overmodulation = enabled;
+}
+
+bool controller_get_latency_compensation(void)
+{
+    return config.latency_compensation;
+}
+
+void controller_set_latency_compensation(bool enabled)
+{
+    config.latency_compensation = enabled;
+}
+
+bool controller_get_fusion(void)
+{
+    return config.fusion;
+}
+
+void controller_set_fusion(bool enabled)
+{
+    config.fusion = enabled;
+    Controller_ResetDeflection();
+}
+
+float controller_get_deflection_user_frame(void)
+{
+    return apply_velocity_transform(state.deflection.deflection, frame_motor_to_user_p());
+}
+
+float controller_get_backlash_user_frame(void)
+{
+    return (state.deflection.offset_rev - state.deflection.offset_fwd) * our_fabsf(frame_motor_to_user_p()->multiplier);
+}
+
+float controller_get_compliance_user_frame(void)
+{
+    return state.deflection.compliance * our_fabsf(frame_motor_to_user_p()->multiplier);
+}
+
+float controller_get_cal_offset_duration(void)
+{
+    return state.cal_durations.offset;
+}
+
+float controller_get_cal_R_duration(void)
+{
+    return state.cal_durations.R;
+}
+
+float controller_get_cal_L_duration(void)
+{
+    return state.cal_durations.L;
+}
+
+float controller_get_cal_sensors_duration(void)
+{
+    return state.cal_durations.sensors;
+}
+
+uint8_t controller_get_cal_stages(void)
+{
+    return state.cal_stages;
+}
+
+void controller_set_cal_stages(uint8_t stages)
+{
+    state.cal_stages = stages & (CAL_STAGES_ALL | CONTROLLER_CALIBRATION_STAGES_VERIFY);
+}
+
+uint8_t controller_get_cal_mismatch(void)
+{
+    return state.cal_mismatch;
+}
+
 void controller_set_motion_plan(MotionPlan mp)
 {
     motion_plan = mp;
@@ -627,6 +983,89 @@ static inline bool Controller_LimitVelocity(const float min_limit, const float m
     return our_clampc(I, Imin, Imax);
 }
 
+static inline bool Controller_FusionActive(void)
+{
+    return config.fusion && (commutation_sensor_p != position_sensor_p);
+}
+
+static inline float Controller_GetVelEstimateMotorFrame(void)
+{
+    if (Controller_FusionActive())
+    {
+        return motor_frame_get_vel_estimate();
+    }
+    return apply_velocity_transform(observer_get_vel_estimate(&position_observer), frame_position_sensor_to_motor_p());
+}
+
+static inline void Controller_ResetDeflection(void)
+{
+    DeflectionEstimate *d = &state.deflection;
+    d->motor_pos_prev = *observer_get_turn_position(&commutation_observer);
+    d->output_pos_prev = *observer_get_turn_position(&position_observer);
+    // Deflection is tracked relative to the current position, so only
+    // the offset difference, the backlash, carries over
+    d->deflection = 0.0f;
+    d->offset_rev -= d->offset_fwd;
+    d->offset_fwd = 0.0f;
+    d->P[0] = DEFLECTION_P_INIT;
+    d->P[1] = 0.0f;
+    d->P[2] = 0.0f;
+    d->P[3] = DEFLECTION_P_INIT;
+    d->P[4] = 0.0f;
+    d->P[5] = DEFLECTION_P_INIT;
+}
+
+// Tracks the difference between the output and motor side positions in
+// the motor frame, and fits the deflection model to it by recursive least
+// squares with exponential forgetting. Samples with Iq close to zero are
+// skipped, as the gearbox may then be anywhere within its play.
+static inline void Controller_UpdateDeflection(float Iq)
+{
+    DeflectionEstimate *d = &state.deflection;
+    const TurnPosition *motor_pos = observer_get_turn_position(&commutation_observer);
+    const TurnPosition *output_pos = observer_get_turn_position(&position_observer);
+    d->deflection += apply_velocity_transform(turn_position_diff(output_pos, &(d->output_pos_prev)), frame_position_sensor_to_motor_p())
+        - apply_velocity_transform(turn_position_diff(motor_pos, &(d->motor_pos_prev)), frame_commutation_sensor_to_motor_p());
+    d->motor_pos_prev = *motor_pos;
+    d->output_pos_prev = *output_pos;
+
+    if (our_fabsf(Iq) < DEFLECTION_MIN_I)
+    {
+        return;
+    }
+    // Regressor is (Iq > 0, Iq < 0, -Iq)
+    const float f0 = (Iq > 0.0f) ? 1.0f : 0.0f;
+    const float f1 = 1.0f - f0;
+    const float f2 = -Iq;
+    float *P = d->P;
+    const float g0 = (P[0] * f0) + (P[1] * f1) + (P[2] * f2);
+    const float g1 = (P[1] * f0) + (P[3] * f1) + (P[4] * f2);
+    const float g2 = (P[2] * f0) + (P[4] * f1) + (P[5] * f2);
+    const float lambda = 1.0f - (PWM_PERIOD_S / DEFLECTION_WINDOW_S);
+    const float inv_den = 1.0f / (lambda + (g0 * f0) + (g1 * f1) + (g2 * f2));
+    const float k0 = g0 * inv_den;
+    const float k1 = g1 * inv_den;
+    const float k2 = g2 * inv_den;
+    const float e = d->deflection - ((d->offset_fwd * f0) + (d->offset_rev * f1) + (d->compliance * f2));
+    d->offset_fwd += k0 * e;
+    d->offset_rev += k1 * e;
+    d->compliance += k2 * e;
+    // Parameters not excited by the motion, such as the offset of a torque
+    // direction not seen for a while, would see their variance grow without
+    // bound. Forgetting is applied as P <- S P S, with S diagonal, and is
+    // suspended for parameters whose variance has reached the limit.
+    const float sf = fast_sqrt(1.0f / lambda);
+    const float s0 = (P[0] < DEFLECTION_P_MAX) ? sf : 1.0f;
+    const float s1 = (P[3] < DEFLECTION_P_MAX) ? sf : 1.0f;
+    const float s2 = (P[5] < DEFLECTION_P_MAX) ? sf : 1.0f;
+    P[0] = (P[0] - (k0 * g0)) * s0 * s0;
+    P[1] = (P[1] - (k0 * g1)) * s0 * s1;
+    P[2] = (P[2] - (k0 * g2)) * s0 * s2;
+    P[3] = (P[3] - (k1 * g1)) * s1 * s1;
+    P[4] = (P[4] - (k1 * g2)) * s1 * s2;
+    P[5] = (P[5] - (k2 * g2)) * s2 * s2;
+}
+
 TM_RAMFUNC void controller_update_I_gains(void)
 {
     config.I_gain = config.I_bw * motor_get_phase_inductance();
@@ -635,6 +1074,11 @@ TM_RAMFUNC void controller_update_I_gains(void)
     config.Id_integral_gain = config.Iq_integral_gain;
 }
 
+void controller_update_load_gains(void)
+{
+    config.load_D = 1.0f - powf(EPSILON, -TWOPI * config.load_bw * PWM_PERIOD_S);
+}
+
 TM_RAMFUNC uint8_t controller_get_warnings(void)
 {
     return state.warnings;
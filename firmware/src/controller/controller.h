@@ -22,6 +22,32 @@
 #include <src/controller/trajectory_planner.h>
 #include <src/controller/homing_planner.h>
 
+// Gearbox deflection between the output and motor sides in the motor
+// frame, modelled as an offset for each torque direction, minus the
+// compliance times Iq. Backlash is the difference between the offsets.
+typedef struct
+{
+    TurnPosition motor_pos_prev; // expressed in commutation sensor frame
+    TurnPosition output_pos_prev; // expressed in position sensor frame
+    float deflection;
+    float offset_fwd;
+    float offset_rev;
+    float compliance;
+    float P[6]; // covariance, upper triangle row-wise
+} DeflectionEstimate;
+
+// Duration of each stage of the last calibration, in seconds
+typedef struct
+{
+    float offset;
+    float R;
+    float L;
+    float sensors;
+} CalibrationDurations;
+
+#define CAL_STAGES_ALL (CONTROLLER_CALIBRATION_STAGES_OFFSET | CONTROLLER_CALIBRATION_STAGES_R \
+    | CONTROLLER_CALIBRATION_STAGES_L | CONTROLLER_CALIBRATION_STAGES_SENSORS)
+
 typedef struct
 {
     controller_state_options state;
@@ -35,7 +61,7 @@ typedef struct
     float Id_estimate;
     float Ibus_est;
     float power_est;
-    float pos_setpoint; // expressed in position frame
+    TurnPosition pos_setpoint; // expressed in position frame
     float vel_setpoint; // expressed in position frame
     float vel_ramp_setpoint;
     float Iq_setpoint; // expressed in commutation frame
@@ -44,7 +70,13 @@ typedef struct
     float vel_integrator;
     float Iq_integrator;
     float Id_integrator;
+    float I_load_estimate; // expressed in commutation frame
+    float vel_prev; // expressed in commutation frame
     float t_plan;
+    DeflectionEstimate deflection;
+    CalibrationDurations cal_durations;
+    uint8_t cal_stages; // to run at the next calibration
+    uint8_t cal_mismatch;
 } ControllerState;
 
 typedef struct
@@ -64,6 +96,14 @@ typedef struct
     float vel_increment;
     float max_Ibus_regen;
     float max_Ibrake;
+    float load_inertia;
+    float load_bw;
+    float load_D;
+    bool load_feedforward;
+    controller_voltage_svm_mode_options svm_mode;
+    bool overmodulation;
+    bool latency_compensation;
+    bool fusion;
 } ControllerConfig;
 
 void Controller_ControlLoop(void);
@@ -88,12 +128,16 @@ float controller_get_Iq_setpoint_user_frame(void);
 float controller_get_Id_setpoint_user_frame(void);
 
 void controller_set_pos_setpoint_user_frame(float value);
+void controller_set_pos_setpoint_turns_user_frame(int32_t turns, float in_turn);
+void controller_set_pos_setpoint_relative_user_frame(const TurnPosition *origin, float offset);
+void controller_get_pos_setpoint(TurnPosition *pos);
 void controller_set_vel_setpoint_user_frame(float value);
 void controller_set_Iq_setpoint_user_frame(float value);
 
 float controller_set_pos_vel_setpoints_user_frame(float pos_setpoint, float vel_setpoint);
 
 float controller_get_Iq_estimate(void);
+void controller_get_modulation_values(FloatTriplet *dc);
 
 float controller_get_Vq_setpoint_user_frame(void);
 
@@ -126,9 +170,40 @@ void controller_set_max_Ibus_regen(float value);
 float controller_get_max_Ibrake(void);
 void controller_set_max_Ibrake(float value);
 
+float controller_get_I_load_estimate(void);
+float controller_get_I_load_estimate_user_frame(void);
+float controller_get_load_inertia(void);
+void controller_set_load_inertia(float value);
+float controller_get_load_bw(void);
+void controller_set_load_bw(float bw);
+bool controller_get_load_feedforward(void);
+void controller_set_load_feedforward(bool enabled);
+
+controller_voltage_svm_mode_options controller_get_svm_mode(void);
+void controller_set_svm_mode(controller_voltage_svm_mode_options mode);
+bool controller_get_overmodulation(void);
+void controller_set_overmodulation(bool enabled);
+bool controller_get_latency_compensation(void);
+void controller_set_latency_compensation(bool enabled);
+
+bool controller_get_fusion(void);
+void controller_set_fusion(bool enabled);
+float controller_get_deflection_user_frame(void);
+float controller_get_backlash_user_frame(void);
+float controller_get_compliance_user_frame(void);
+
+float controller_get_cal_offset_duration(void);
+float controller_get_cal_R_duration(void);
+float controller_get_cal_L_duration(void);
+float controller_get_cal_sensors_duration(void);
+uint8_t controller_get_cal_stages(void);
+void controller_set_cal_stages(uint8_t stages);
+uint8_t controller_get_cal_mismatch(void);
+
 void controller_set_motion_plan(MotionPlan mp);
 
 void controller_update_I_gains(void);
+void controller_update_load_gains(void);
 
 uint8_t controller_get_warnings(void);
 uint8_t controller_get_errors(void);
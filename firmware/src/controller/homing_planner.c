@@ -41,14 +41,16 @@ TM_RAMFUNC bool homing_planner_evaluate()
         {
             return false;
         }
-        const float next_pos_setpoint = current_pos_setpoint - config.homing_velocity * PWM_PERIOD_S;
-        controller_set_pos_setpoint_user_frame(next_pos_setpoint);
+        TurnPosition pos_setpoint;
+        controller_get_pos_setpoint(&pos_setpoint);
+        controller_set_pos_setpoint_relative_user_frame(&pos_setpoint, -config.homing_velocity * PWM_PERIOD_S);
         controller_set_vel_setpoint_user_frame(-config.homing_velocity);
     }
     else if (state.home_t_current < config.max_homing_t)
     {
-        const float next_pos_setpoint = current_pos_setpoint + config.homing_velocity * PWM_PERIOD_S;
-        controller_set_pos_setpoint_user_frame(next_pos_setpoint);
+        TurnPosition pos_setpoint;
+        controller_get_pos_setpoint(&pos_setpoint);
+        controller_set_pos_setpoint_relative_user_frame(&pos_setpoint, config.homing_velocity * PWM_PERIOD_S);
         controller_set_vel_setpoint_user_frame(config.homing_velocity);
 
         const float observer_pos = user_frame_get_pos_estimate();
@@ -21,6 +21,7 @@
 #include <src/can/can_endpoints.h>
 #include <src/utils/utils.h>
 #include <src/controller/trajectory_planner.h>
+#include <src/xfs.h>
 
 static TrajPlannerConfig config = {
 	.max_accel = SENSOR_COMMON_RES_TICKS_FLOAT,
@@ -28,17 +29,50 @@ static TrajPlannerConfig config = {
 	.max_vel = 50000.0f,
 	.deltat_accel = 2.0f,
 	.deltat_decel = 2.0f,
-	.deltat_total = 5.0f
+	.deltat_total = 5.0f,
+	.shaper_frequency = 10.0f,
+	.shaper_damping = 0.05f,
+	.shaper_type = TRAJ_PLANNER_SHAPER_TYPE_NONE
 };
 
 static PlannerState state = {0};
+static InputShaper shaper = {0};
+
+static uint8_t shaper_compute_impulses(float *amplitude, float *delay);
+static float shaper_lead(void);
+static void shaper_prime(float pos, float vel);
+static void planner_offset_plan(MotionPlan *plan, float offset);
+
+// Distance in the user frame from the position setpoint to a target
+// given as whole position sensor turns plus a position within the turn
+static float planner_distance_to_turns(int32_t turns, float in_turn)
+{
+	TurnPosition target = {.turns = turns, .ticks = 0.0f};
+	turn_position_add(&target, apply_transform(in_turn, frame_user_to_position_sensor_p()));
+	TurnPosition origin;
+	controller_get_pos_setpoint(&origin);
+	return apply_velocity_transform(turn_position_diff(&target, &origin), frame_position_sensor_to_user_p());
+}
 
 bool planner_move_to_tlimit(float p_target)
+{
+	return planner_move_by_tlimit(p_target - controller_get_pos_setpoint_user_frame());
+}
+
+bool planner_move_to_turns_tlimit(int32_t turns, float in_turn)
+{
+	return planner_move_by_tlimit(planner_distance_to_turns(turns, in_turn));
+}
+
+bool planner_move_by_tlimit(float distance)
 {
 	bool response = false;
 	MotionPlan motion_plan = {0};
-	if (!errors_exist() && planner_prepare_plan_tlimit(p_target, config.deltat_total, config.deltat_accel, config.deltat_decel, &motion_plan))
+	const float lead = shaper_lead();
+	if (!errors_exist() && planner_prepare_plan_tlimit(distance - lead, config.deltat_total, config.deltat_accel, config.deltat_decel, &motion_plan))
 	{
+		planner_offset_plan(&motion_plan, lead);
+		shaper_prime(motion_plan.p_0, motion_plan.v_0);
 		controller_set_motion_plan(motion_plan);
 		controller_set_mode(CONTROLLER_MODE_TRAJECTORY);
 		response = true;
@@ -47,11 +81,24 @@ bool planner_move_to_tlimit(float p_target)
 }
 
 bool planner_move_to_vlimit(float p_target)
+{
+	return planner_move_by_vlimit(p_target - controller_get_pos_setpoint_user_frame());
+}
+
+bool planner_move_to_turns_vlimit(int32_t turns, float in_turn)
+{
+	return planner_move_by_vlimit(planner_distance_to_turns(turns, in_turn));
+}
+
+bool planner_move_by_vlimit(float distance)
 {
 	bool response = false;
 	MotionPlan motion_plan = {0};
-	if (!errors_exist() && planner_prepare_plan_vlimit(p_target, config.max_vel, config.max_accel, config.max_decel, &motion_plan))
+	const float lead = shaper_lead();
+	if (!errors_exist() && planner_prepare_plan_vlimit(distance - lead, config.max_vel, config.max_accel, config.max_decel, &motion_plan))
 	{
+		planner_offset_plan(&motion_plan, lead);
+		shaper_prime(motion_plan.p_0, motion_plan.v_0);
 		controller_set_motion_plan(motion_plan);
 		controller_set_mode(CONTROLLER_MODE_TRAJECTORY);
 		response = true;
@@ -59,10 +106,10 @@ bool planner_move_to_vlimit(float p_target)
 	return response;
 }
 
-bool planner_prepare_plan_tlimit(float p_target, float deltat_total, float deltat_accel, float deltat_decel, MotionPlan *plan)
+bool planner_prepare_plan_tlimit(float S, float deltat_total, float deltat_accel, float deltat_decel, MotionPlan *plan)
 {
-	float p_0 = controller_get_pos_setpoint_user_frame();
-	float S = p_target - p_0;
+	// Plan positions are relative to the current setpoint
+	const float p_0 = 0.0f;
 	float v_0 = controller_get_vel_setpoint_user_frame();
 	float deltat_cruise = deltat_total - deltat_accel - deltat_decel;
 	float v_cruise = (S - 0.5f * deltat_accel * v_0) / (0.5f * deltat_accel + deltat_cruise + 0.5f * deltat_decel);
@@ -83,8 +130,9 @@ bool planner_prepare_plan_tlimit(float p_target, float deltat_total, float delta
 	float acc = (v_cruise - v_0) / deltat_accel;
 	float dec = v_cruise / deltat_decel;
 	// Assign everything
+	controller_get_pos_setpoint(&plan->origin);
 	plan->p_0 = p_0;
-	plan->p_target = p_target;
+	plan->p_target = S;
 	plan->deltat_accel = deltat_accel;
 	plan->t_acc_cruise = deltat_accel;
 	plan->deltat_cruise = deltat_cruise;
@@ -101,10 +149,10 @@ bool planner_prepare_plan_tlimit(float p_target, float deltat_total, float delta
 	return true;
 }
 
-bool planner_prepare_plan_vlimit(float p_target, float v_max, float a_max, float d_max, MotionPlan *plan)
+bool planner_prepare_plan_vlimit(float S, float v_max, float a_max, float d_max, MotionPlan *plan)
 {
-	const float p_0 = controller_get_pos_setpoint_user_frame();
-	const float S = p_target - p_0;
+	// Plan positions are relative to the current setpoint
+	const float p_0 = 0.0f;
 	const float v_0 = controller_get_vel_setpoint_user_frame();
 	const float sign = S >= 0 ? 1.0f : -1.0f;
 	if (S == 0.0f)
@@ -119,6 +167,7 @@ bool planner_prepare_plan_vlimit(float p_target, float v_max, float a_max, float
 		const float dec = sign_fs * d_max;
 		const float p_target_fullstop = p_0 + v_0 * deltat_decel - 0.5f * dec * deltat_decel * deltat_decel;
 
+		controller_get_pos_setpoint(&plan->origin);
 		plan->p_0 = p_0;
 		plan->deltat_decel = deltat_decel;
 		plan->t_end = deltat_decel;
@@ -159,8 +208,9 @@ bool planner_prepare_plan_vlimit(float p_target, float v_max, float a_max, float
 		const float t_end = deltat_accel + deltat_decel;
 		const float p_acc_cruise = p_0 + v_0 * deltat_accel + 0.5f * acc * deltat_accel * deltat_accel;
 
+		controller_get_pos_setpoint(&plan->origin);
 		plan->p_0 = p_0;
-		plan->p_target = p_target;
+		plan->p_target = S;
 		plan->acc = acc;
 		plan->dec = dec;
 		plan->v_cruise = v_reached;
@@ -191,8 +241,9 @@ bool planner_prepare_plan_vlimit(float p_target, float v_max, float a_max, float
 		const float p_acc_cruise = p_0 + v_0 * deltat_accel + 0.5f * acc * deltat_accel * deltat_accel;
 		const float p_cruise_dec = p_acc_cruise + v_cruise * deltat_cruise;
 
+		controller_get_pos_setpoint(&plan->origin);
 		plan->p_0 = p_0;
-		plan->p_target = p_target;
+		plan->p_target = S;
 		plan->acc = acc;
 		plan->dec = dec;
 		plan->v_cruise = v_cruise;
@@ -306,32 +357,241 @@ TM_RAMFUNC uint8_t planner_get_errors(void)
 	return state.errors;
 }
 
-TM_RAMFUNC bool traj_planner_evaluate(float t, MotionPlan *plan)
+static inline bool planner_evaluate_raw(float t, const MotionPlan *plan, float *pos, float *vel)
 {
-	// We assume that t is zero at the start of trajectory
-	bool response = true;
 	if (t < plan->t_acc_cruise)
 	{
-		controller_set_pos_setpoint_user_frame(plan->p_0 + (plan->v_0 * t) + (0.5f * plan->acc * t * t));
-		controller_set_vel_setpoint_user_frame(plan->v_0 + (plan->acc * t));
+		*pos = plan->p_0 + (plan->v_0 * t) + (0.5f * plan->acc * t * t);
+		*vel = plan->v_0 + (plan->acc * t);
 	}
 	else if (t < plan->t_cruise_dec)
 	{
 		const float tr = (t - plan->t_acc_cruise);
-		controller_set_pos_setpoint_user_frame(plan->p_acc_cruise + (plan->v_cruise * tr));
-		controller_set_vel_setpoint_user_frame(plan->v_cruise);
+		*pos = plan->p_acc_cruise + (plan->v_cruise * tr);
+		*vel = plan->v_cruise;
 	}
 	else if (t <= plan->t_end)
 	{
 		const float tr = (t - plan->t_cruise_dec);
-		controller_set_pos_setpoint_user_frame(plan->p_cruise_dec + (plan->v_cruise * tr) - (0.5f * plan->dec * tr * tr));
-		controller_set_vel_setpoint_user_frame(plan->v_cruise - (tr * plan->dec));
+		*pos = plan->p_cruise_dec + (plan->v_cruise * tr) - (0.5f * plan->dec * tr * tr);
+		*vel = plan->v_cruise - (tr * plan->dec);
 	}
 	else
 	{
-		response = false;
+		return false;
 	}
-	return response;
+	return true;
+}
+
+// Returns the buffered setpoint delay_cycles control cycles in the past,
+// linearly interpolated between stored samples. The head slot always
+// holds the current (raw) setpoint.
+static inline float shaper_sample(const float *buffer, float delay_cycles)
+{
+	const float head_age = (float)(shaper.counter + 1u);
+	const float current = buffer[shaper.head];
+	if (delay_cycles <= head_age)
+	{
+		const float previous = buffer[(shaper.head + SHAPER_BUFFER_SIZE - 1u) % SHAPER_BUFFER_SIZE];
+		return current + (delay_cycles / head_age) * (previous - current);
+	}
+	const float x = (delay_cycles - head_age) / shaper.decimation;
+	const uint32_t n = (uint32_t)x;
+	const float a = buffer[(shaper.head + SHAPER_BUFFER_SIZE - 1u - n) % SHAPER_BUFFER_SIZE];
+	const float b = buffer[(shaper.head + SHAPER_BUFFER_SIZE - 2u - n) % SHAPER_BUFFER_SIZE];
+	return a + (x - n) * (b - a);
+}
+
+TM_RAMFUNC bool traj_planner_evaluate(float t, MotionPlan *plan)
+{
+	// We assume that t is zero at the start of trajectory
+	float pos = 0.0f;
+	float vel = 0.0f;
+	if (shaper.n_impulses <= 1u)
+	{
+		if (!planner_evaluate_raw(t, plan, &pos, &vel))
+		{
+			return false;
+		}
+		controller_set_pos_setpoint_relative_user_frame(&plan->origin, pos);
+		controller_set_vel_setpoint_user_frame(vel);
+		return true;
+	}
+	if (t > plan->t_end + shaper.delay)
+	{
+		return false;
+	}
+	// Past the end of the plan the raw trajectory rests at its
+	// final point, while the delayed impulses catch up.
+	if (t < plan->t_end)
+	{
+		planner_evaluate_raw(t, plan, &pos, &vel);
+	}
+	else
+	{
+		planner_evaluate_raw(plan->t_end, plan, &pos, &vel);
+		vel = 0.0f;
+	}
+	shaper.counter++;
+	if (shaper.counter >= shaper.decimation)
+	{
+		shaper.counter = 0;
+		shaper.head = (shaper.head + 1u) % SHAPER_BUFFER_SIZE;
+	}
+	shaper.pos[shaper.head] = pos;
+	shaper.vel[shaper.head] = vel;
+
+	float pos_shaped = 0.0f;
+	float vel_shaped = 0.0f;
+	for (uint8_t i = 0; i < shaper.n_impulses; i++)
+	{
+		pos_shaped += shaper.amplitude[i] * shaper_sample(shaper.pos, shaper.delay_cycles[i]);
+		vel_shaped += shaper.amplitude[i] * shaper_sample(shaper.vel, shaper.delay_cycles[i]);
+	}
+	controller_set_pos_setpoint_relative_user_frame(&plan->origin, pos_shaped);
+	controller_set_vel_setpoint_user_frame(vel_shaped);
+	return true;
+}
+
+// The shaper history advances with each evaluation, so shaped
+// trajectories must be evaluated every cycle
+TM_RAMFUNC bool traj_planner_is_shaped(void)
+{
+	return shaper.n_impulses > 1u;
+}
+
+uint8_t planner_get_shaper_type(void)
+{
+	return config.shaper_type;
+}
+
+void planner_set_shaper_type(uint8_t type)
+{
+	if (type < TRAJ_PLANNER_SHAPER_TYPE__MAX)
+	{
+		config.shaper_type = type;
+	}
+}
+
+float planner_get_shaper_frequency(void)
+{
+	return config.shaper_frequency;
+}
+
+void planner_set_shaper_frequency(float frequency)
+{
+	if (frequency >= SHAPER_MIN_FREQUENCY)
+	{
+		config.shaper_frequency = frequency;
+	}
+}
+
+float planner_get_shaper_damping(void)
+{
+	return config.shaper_damping;
+}
+
+void planner_set_shaper_damping(float damping)
+{
+	if (damping >= 0.0f && damping <= SHAPER_MAX_DAMPING)
+	{
+		config.shaper_damping = damping;
+	}
+}
+
+float planner_get_shaper_delay(void)
+{
+	float amplitude[SHAPER_MAX_IMPULSES];
+	float delay[SHAPER_MAX_IMPULSES];
+	const uint8_t n = shaper_compute_impulses(amplitude, delay);
+	return delay[n - 1u];
+}
+
+// Computes the impulse sequence of the configured shaper, see
+// Singer & Seering, "Preshaping Command Inputs to Reduce System
+// Vibration". Amplitudes sum to one so the final position is unchanged.
+static uint8_t shaper_compute_impulses(float *amplitude, float *delay)
+{
+	amplitude[0] = 1.0f;
+	delay[0] = 0.0f;
+	if (config.shaper_type == TRAJ_PLANNER_SHAPER_TYPE_NONE)
+	{
+		return 1;
+	}
+	const float damping_factor = sqrtf(1.0f - config.shaper_damping * config.shaper_damping);
+	const float K = expf(-config.shaper_damping * PI / damping_factor);
+	const float half_period = 0.5f / (config.shaper_frequency * damping_factor);
+	if (config.shaper_type == TRAJ_PLANNER_SHAPER_TYPE_ZV)
+	{
+		const float norm = 1.0f / (1.0f + K);
+		amplitude[0] = norm;
+		amplitude[1] = K * norm;
+		delay[1] = half_period;
+		return 2;
+	}
+	const float norm = 1.0f / ((1.0f + K) * (1.0f + K));
+	amplitude[0] = norm;
+	amplitude[1] = 2.0f * K * norm;
+	amplitude[2] = K * K * norm;
+	delay[1] = half_period;
+	delay[2] = 2.0f * half_period;
+	return 3;
+}
+
+// Resets the setpoint history to the start of a new plan. Called
+// before each move, so configuration changes apply from the next move.
+static void shaper_prime(float pos, float vel)
+{
+	float delay[SHAPER_MAX_IMPULSES];
+	shaper.n_impulses = shaper_compute_impulses(shaper.amplitude, delay);
+	shaper.delay = delay[shaper.n_impulses - 1u];
+	// Reserve two slots for the partially filled head and for interpolation
+	const float decimation = ceilf(shaper.delay * PWM_FREQ_HZ / (SHAPER_BUFFER_SIZE - 3));
+	shaper.decimation = decimation > 1.0f ? (uint16_t)decimation : 1u;
+	for (uint8_t i = 0; i < shaper.n_impulses; i++)
+	{
+		shaper.delay_cycles[i] = delay[i] * PWM_FREQ_HZ;
+	}
+	// Back-fill the history as if the setpoint had been moving at vel.
+	// The head slot is the present, and the slot n before it is
+	// 1 + n * decimation cycles old, see shaper_sample().
+	shaper.pos[0] = pos;
+	shaper.vel[0] = vel;
+	for (uint8_t n = 0; n < SHAPER_BUFFER_SIZE - 1u; n++)
+	{
+		const float age = (1.0f + (float)n * shaper.decimation) * PWM_PERIOD_S;
+		shaper.pos[SHAPER_BUFFER_SIZE - 1u - n] = pos - vel * age;
+		shaper.vel[SHAPER_BUFFER_SIZE - 1u - n] = vel;
+	}
+	shaper.head = 0;
+	shaper.counter = 0;
+}
+
+// Distance by which the input of the configured shaper runs ahead of
+// its output at the current velocity setpoint. The shaped setpoint
+// trails its input by the amplitude-weighted impulse delay, so a move
+// that starts while moving plans its input from this far ahead, and
+// the shaped setpoint continues without a step.
+static float shaper_lead(void)
+{
+	float amplitude[SHAPER_MAX_IMPULSES];
+	float delay[SHAPER_MAX_IMPULSES];
+	const uint8_t n = shaper_compute_impulses(amplitude, delay);
+	float lag = 0.0f;
+	for (uint8_t i = 0; i < n; i++)
+	{
+		lag += amplitude[i] * delay[i];
+	}
+	return lag * controller_get_vel_setpoint_user_frame();
+}
+
+// Shifts all plan positions by offset, relative to the plan origin
+static void planner_offset_plan(MotionPlan *plan, float offset)
+{
+	plan->p_0 += offset;
+	plan->p_target += offset;
+	plan->p_acc_cruise += offset;
+	plan->p_cruise_dec += offset;
 }
 
 TrajPlannerConfig *traj_planner_get_config(void)
@@ -20,6 +20,13 @@
 
 #include <src/common.h>
 
+// Length of the setpoint history used by the input shaper. Samples
+// are decimated so that the longest impulse delay always fits.
+#define SHAPER_BUFFER_SIZE (64)
+#define SHAPER_MAX_IMPULSES (3)
+#define SHAPER_MIN_FREQUENCY (0.5f)
+#define SHAPER_MAX_DAMPING (0.7f)
+
 typedef struct {
 	float max_accel;
 	float max_decel;
@@ -27,18 +34,37 @@ typedef struct {
     float deltat_accel;
     float deltat_total;
     float deltat_decel;
+    float shaper_frequency;
+    float shaper_damping;
+    uint8_t shaper_type;
 } TrajPlannerConfig;
 
 typedef struct {
 	uint8_t errors;
 } PlannerState;
 
+typedef struct
+{
+    float pos[SHAPER_BUFFER_SIZE];
+    float vel[SHAPER_BUFFER_SIZE];
+    float amplitude[SHAPER_MAX_IMPULSES];
+    float delay_cycles[SHAPER_MAX_IMPULSES];
+    float delay;
+    uint16_t decimation;
+    uint16_t counter;
+    uint8_t head;
+    uint8_t n_impulses;
+} InputShaper;
+
 typedef struct
 {
     // NOTE: The members of this struct are redundant,
     // i.e. not all are necessary to fully define a
     // trajectory. However this definition reduces the
     // computation during trajectory evaluation.
+    // origin is in the position sensor frame, while the
+    // positions below are user frame distances from it.
+    TurnPosition origin;
 	float p_0;
     float p_target;
     float deltat_accel;
@@ -57,9 +83,13 @@ typedef struct
 } MotionPlan;
 
 bool planner_move_to_tlimit(float p_target);
+bool planner_move_to_turns_tlimit(int32_t turns, float in_turn);
+bool planner_move_by_tlimit(float distance);
 bool planner_move_to_vlimit(float p_targetl);
-bool planner_prepare_plan_tlimit(float p_target, float deltat_total, float deltat_accel, float deltat_decel, MotionPlan *plan);
-bool planner_prepare_plan_vlimit(float p_target, float v_max, float a_max, float d_max, MotionPlan *plan);
+bool planner_move_to_turns_vlimit(int32_t turns, float in_turn);
+bool planner_move_by_vlimit(float distance);
+bool planner_prepare_plan_tlimit(float S, float deltat_total, float deltat_accel, float deltat_decel, MotionPlan *plan);
+bool planner_prepare_plan_vlimit(float S, float v_max, float a_max, float d_max, MotionPlan *plan);
 bool planner_set_max_accel(float max_accel);
 bool planner_set_max_decel(float max_decel);
 float planner_get_max_accel(void);
@@ -72,10 +102,18 @@ float planner_get_deltat_total(void);
 bool planner_set_deltat_total(float deltat_total);
 float planner_get_deltat_decel(void);
 bool planner_set_deltat_decel(float deltat_decel);
+uint8_t planner_get_shaper_type(void);
+void planner_set_shaper_type(uint8_t type);
+float planner_get_shaper_frequency(void);
+void planner_set_shaper_frequency(float frequency);
+float planner_get_shaper_damping(void);
+void planner_set_shaper_damping(float damping);
+float planner_get_shaper_delay(void);
 
 uint8_t planner_get_errors(void);
 
 bool traj_planner_evaluate(float t, MotionPlan *plan);
+bool traj_planner_is_shaped(void);
 
 TrajPlannerConfig *traj_planner_get_config(void);
 void traj_planner_restore_config(TrajPlannerConfig *config_);
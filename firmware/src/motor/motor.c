@@ -59,72 +59,149 @@ static MotorState state = {0};
 
 void motor_reset_calibration()
 {
-	config.pole_pairs = 7;
-	// Important! We only reset resistance and 
-	// inductance measurements if the motor is
-	// not a gimbal, otherwise they will not
-	// be recalibrated and will stay at default
-	// values!
+	motor_reset_resistance();
+	motor_reset_inductance();
+	motor_reset_pole_pairs();
+}
+
+// Important! We only reset resistance and 
+// inductance measurements if the motor is
+// not a gimbal, otherwise they will not
+// be recalibrated and will stay at default
+// values!
+void motor_reset_resistance(void)
+{
 	if (!motor_get_is_gimbal())
 	{
 		config.phase_resistance = 0.1f;
-		config.phase_inductance = 1e-5f;
 		config.resistance_calibrated = false;
+	}
+}
+
+void motor_reset_inductance(void)
+{
+	if (!motor_get_is_gimbal())
+	{
+		config.phase_inductance = 1e-5f;
 		config.inductance_calibrated = false;
 	}
+}
+
+void motor_reset_pole_pairs(void)
+{
+	config.pole_pairs = 7;
 	config.poles_calibrated = false;
 }
 
-bool motor_calibrate_resistance(void)
+// Regulates the phase A current to I_cal, starting from the voltage
+// in V_setpoint, until the voltage settles or len cycles pass. The
+// final voltage and filtered current are returned in V_setpoint and
+// I_meas.
+static bool motor_drive_calibration_current(float *V_setpoint, float *I_meas, uint32_t len)
 {
-    if (!motor_get_is_gimbal())
-    {
-        FloatTriplet I_phase_meas = {0.0f};
-        FloatTriplet modulation_values = {0.0f};
+    FloatTriplet I_phase_meas = {0.0f};
+    FloatTriplet modulation_values = {0.0f};
 
-		ADC_get_phase_currents(&I_phase_meas);
+    ADC_get_phase_currents(&I_phase_meas);
 
-		float I_meas = I_phase_meas.A;
-		float I_cal = motor_get_I_cal();
-        float V_setpoint = 0.0f;
-        uint32_t abnormal_condition_count = 0;
+    *I_meas = I_phase_meas.A;
+    const float I_cal = motor_get_I_cal();
+    uint32_t abnormal_condition_count = 0;
+    // Ends early once the voltage needed to hold I_cal settles
+    ConvergenceMonitor monitor = {0};
+    bool converged = false;
 
-        for (uint32_t i = 0; i < CAL_R_LEN; i++)
-        {
-            ADC_get_phase_currents(&I_phase_meas);
+    for (uint32_t i = 0; (i < len) && (converged == false); i++)
+    {
+        ADC_get_phase_currents(&I_phase_meas);
 
-            V_setpoint += CAL_V_GAIN * (I_cal - I_meas);
-			I_meas += CAL_I_GAIN * (I_phase_meas.A - I_meas);
+        *V_setpoint += CAL_V_GAIN * (I_cal - *I_meas);
+        *I_meas += CAL_I_GAIN * (I_phase_meas.A - *I_meas);
 
-            // Debounced abnormal voltage check (after warm-up period)
-            if (i > CAL_R_WARMUP_ITERATIONS)
+        // Debounced abnormal voltage check (after warm-up period)
+        if (i > CAL_R_WARMUP_ITERATIONS)
+        {
+            if (*V_setpoint > MAX_CALIBRATION_VOLTAGE && *I_meas < MIN_CALIBRATION_CURRENT)
             {
-                if (V_setpoint > MAX_CALIBRATION_VOLTAGE && I_meas < MIN_CALIBRATION_CURRENT)
-                {
-                    abnormal_condition_count++;
-                    if (abnormal_condition_count >= CAL_R_ABNORMAL_DEBOUNCE)
-                    {
-                        uint8_t *error_ptr = motor_get_error_ptr();
-                        *error_ptr |= MOTOR_ERRORS_ABNORMAL_CALIBRATION_VOLTAGE;
-                        gate_driver_set_duty_cycle(&three_phase_zero);
-                        return false;
-                    }
-                }
-                else
+                abnormal_condition_count++;
+                if (abnormal_condition_count >= CAL_R_ABNORMAL_DEBOUNCE)
                 {
-                    abnormal_condition_count = 0;  // Reset counter if condition clears
+                    uint8_t *error_ptr = motor_get_error_ptr();
+                    *error_ptr |= MOTOR_ERRORS_ABNORMAL_CALIBRATION_VOLTAGE;
+                    gate_driver_set_duty_cycle(&three_phase_zero);
+                    return false;
                 }
             }
+            else
+            {
+                abnormal_condition_count = 0;  // Reset counter if condition clears
+            }
+            converged = convergence_update(&monitor, *V_setpoint, CAL_CONV_BLOCK_LEN, CAL_CONV_REL_TOL * our_fabsf(*V_setpoint));
+        }
+
+        const float pwm_setpoint = *V_setpoint / system_get_Vbus();
+        SVM(pwm_setpoint, 0.0f, &modulation_values.A, &modulation_values.B, &modulation_values.C);
+        gate_driver_set_duty_cycle(&modulation_values);
+        wait_for_control_loop_interrupt();
+    }
+    gate_driver_set_duty_cycle(&three_phase_zero);
+    return true;
+}
 
-            const float pwm_setpoint = V_setpoint / system_get_Vbus();
-            SVM(pwm_setpoint, 0.0f, &modulation_values.A, &modulation_values.B, &modulation_values.C);
-            gate_driver_set_duty_cycle(&modulation_values);
-            wait_for_control_loop_interrupt();
+// Applies a square voltage wave to phase A until the current ripple
+// settles or len cycles pass, and returns the inductance.
+static float motor_measure_inductance(uint32_t len)
+{
+    float V_setpoint = 0.0f;
+    float I_low = 0.0f;
+    float I_high = 0.0f;
+    FloatTriplet I_phase_meas = {0.0f};
+    FloatTriplet modulation_values = {0.0f};
+    // Blocks span a whole number of voltage periods, so the sums
+    // remain balanced.
+    ConvergenceMonitor monitor = {0};
+    bool converged = false;
+    uint32_t i = 0;
+
+    for (; (i < len) && (converged == false); i++)
+    {
+        ADC_get_phase_currents(&I_phase_meas);
+        float ripple;
+        if ((i & 0x2u) == 0x2u)
+        {
+            I_high += I_phase_meas.A;
+            V_setpoint = -CAL_V_INDUCTANCE;
+            ripple = I_phase_meas.A;
+        }
+        else
+        {
+            I_low += I_phase_meas.A;
+            V_setpoint = CAL_V_INDUCTANCE;
+            ripple = -I_phase_meas.A;
         }
-        
-        const float R = our_fabsf(V_setpoint / I_cal);
-        gate_driver_set_duty_cycle(&three_phase_zero);
-        
+        converged = convergence_update(&monitor, ripple, CAL_CONV_BLOCK_LEN, CAL_CONV_REL_TOL * our_fabsf(I_high - I_low) / (i + 1));
+        const float pwm_setpoint = V_setpoint / system_get_Vbus();
+        SVM(pwm_setpoint, 0.0f, &modulation_values.A, &modulation_values.B, &modulation_values.C);
+        gate_driver_set_duty_cycle(&modulation_values);
+        wait_for_control_loop_interrupt();
+    }
+    gate_driver_set_duty_cycle(&three_phase_zero);
+    const float num_cycles = i / 2;
+    const float dI_by_dt = (I_high - I_low) / (PWM_PERIOD_S * num_cycles);
+    return CAL_V_INDUCTANCE / dI_by_dt;
+}
+
+bool motor_calibrate_resistance(void)
+{
+    if (!motor_get_is_gimbal())
+    {
+        float V_setpoint = 0.0f;
+        float I_meas;
+        if (!motor_drive_calibration_current(&V_setpoint, &I_meas, CAL_R_LEN))
+        {
+            return false;
+        }
+        const float R = our_fabsf(V_setpoint / motor_get_I_cal());
         if ((R <= MIN_PHASE_RESISTANCE) || (R >= MAX_PHASE_RESISTANCE))
         {
             uint8_t *error_ptr = motor_get_error_ptr();
@@ -144,34 +221,7 @@ bool motor_calibrate_inductance(void)
 {
     if (!motor_get_is_gimbal())
     {
-        float V_setpoint = 0.0f;
-        float I_low = 0.0f;
-        float I_high = 0.0f;
-        FloatTriplet I_phase_meas = {0.0f};
-        FloatTriplet modulation_values = {0.0f};
-
-        for (uint32_t i = 0; i < CAL_L_LEN; i++)
-        {
-            ADC_get_phase_currents(&I_phase_meas);
-            if ((i & 0x2u) == 0x2u)
-            {
-                I_high += I_phase_meas.A;
-                V_setpoint = -CAL_V_INDUCTANCE;
-            }
-            else
-            {
-                I_low += I_phase_meas.A;
-                V_setpoint = CAL_V_INDUCTANCE;
-            }
-            const float pwm_setpoint = V_setpoint / system_get_Vbus();
-            SVM(pwm_setpoint, 0.0f, &modulation_values.A, &modulation_values.B, &modulation_values.C);
-            gate_driver_set_duty_cycle(&modulation_values);
-            wait_for_control_loop_interrupt();
-        }
-        const float num_cycles = CAL_L_LEN / 2;
-        const float dI_by_dt = (I_high - I_low) / (PWM_PERIOD_S * num_cycles);
-        const float L = CAL_V_INDUCTANCE / dI_by_dt;
-        gate_driver_set_duty_cycle(&three_phase_zero);
+        const float L = motor_measure_inductance(CAL_L_LEN);
         if ((L <= MIN_PHASE_INDUCTANCE) || (L >= MAX_PHASE_INDUCTANCE))
         {
             uint8_t *error_ptr = motor_get_error_ptr();
@@ -187,6 +237,36 @@ bool motor_calibrate_inductance(void)
     return true;
 }
 
+bool motor_verify_resistance(void)
+{
+    if (!motor_get_is_gimbal())
+    {
+        // Starting from the stored resistance, the current regulation
+        // does not settle in the short verification time, so the
+        // resistance is taken from the measured current instead.
+        float V_setpoint = config.phase_resistance * motor_get_I_cal();
+        float I_meas;
+        if (!motor_drive_calibration_current(&V_setpoint, &I_meas, CAL_VERIFY_LEN)
+            || (I_meas < MIN_CALIBRATION_CURRENT))
+        {
+            return false;
+        }
+        const float R = our_fabsf(V_setpoint / I_meas);
+        return our_fabsf(R - config.phase_resistance) < CAL_VERIFY_REL_TOL * config.phase_resistance;
+    }
+    return true;
+}
+
+bool motor_verify_inductance(void)
+{
+    if (!motor_get_is_gimbal())
+    {
+        const float L = motor_measure_inductance(CAL_VERIFY_LEN);
+        return our_fabsf(L - config.phase_inductance) < CAL_VERIFY_REL_TOL * config.phase_inductance;
+    }
+    return true;
+}
+
 TM_RAMFUNC uint8_t motor_find_pole_pairs(uint32_t ticks, float mpos_start, float mpos_end, float epos_rad)
 {
 	const float mpos_diff = our_fabsf(mpos_end - mpos_start);
@@ -297,6 +377,21 @@ TM_RAMFUNC bool motor_get_calibrated(void)
 	return config.resistance_calibrated && config.inductance_calibrated && config.poles_calibrated;
 }
 
+bool motor_get_resistance_calibrated(void)
+{
+	return config.resistance_calibrated;
+}
+
+bool motor_get_inductance_calibrated(void)
+{
+	return config.inductance_calibrated;
+}
+
+bool motor_get_poles_calibrated(void)
+{
+	return config.poles_calibrated;
+}
+
 TM_RAMFUNC bool motor_get_is_gimbal(void)
 {
 	return config.is_gimbal;
@@ -56,6 +56,8 @@
 #define CAL_R_WARMUP_ITERATIONS (1500u)   // ~75ms warm-up at 20kHz
 #define CAL_R_ABNORMAL_DEBOUNCE (300u)     // ~15ms debounce at 20kHz
 
+_Static_assert((CAL_CONV_BLOCK_LEN % 4) == 0, "Inductance calibration blocks must span whole voltage periods");
+
 
 
 typedef struct
@@ -79,8 +81,13 @@ typedef struct
 } MotorState;
 
 void motor_reset_calibration(void);
+void motor_reset_resistance(void);
+void motor_reset_inductance(void);
+void motor_reset_pole_pairs(void);
 bool motor_calibrate_resistance(void);
 bool motor_calibrate_inductance(void);
+bool motor_verify_resistance(void);
+bool motor_verify_inductance(void);
 
 uint8_t motor_get_pole_pairs(void);
 uint8_t motor_find_pole_pairs(uint32_t ticks, float mpos_start, float mpos_end, float epos_rad);
@@ -98,6 +105,9 @@ float motor_get_I_cal(void);
 void motor_set_I_cal(float I);
 
 bool motor_get_calibrated(void);
+bool motor_get_resistance_calibrated(void);
+bool motor_get_inductance_calibrated(void);
+bool motor_get_poles_calibrated(void);
 
 bool motor_get_is_gimbal(void);
 void motor_set_is_gimbal(bool gimbal);
@@ -113,7 +123,10 @@ static inline void set_epos_and_wait(float angle, float I_setpoint)
     FloatTriplet modulation_values = {0.0f};
     float pwm_setpoint = (I_setpoint * motor_get_phase_resistance()) / system_get_Vbus();
     our_clampc(&pwm_setpoint, -PWM_LIMIT, PWM_LIMIT);
-    SVM(pwm_setpoint * fast_cos(angle), pwm_setpoint * fast_sin(angle),
+    float c;
+    float s;
+    fast_sincos(angle, &s, &c);
+    SVM(pwm_setpoint * c, pwm_setpoint * s,
         &modulation_values.A, &modulation_values.B, &modulation_values.C);
     gate_driver_set_duty_cycle(&modulation_values);
     wait_for_control_loop_interrupt();
@@ -164,3 +164,40 @@ PAC5XXX_RAMFUNC void flash_write(uint8_t *p_dest, uint8_t *p_src, uint32_t size_
 }
 
 
+
+//==============================================================================
+/// @brief Write a single aligned 16-byte Flash row, and return as soon as
+///        Flash can be read again
+///
+/// @param p_dest      pointer to destination FLASH row, 16-byte aligned
+/// @param p_src       pointer to the 4 words to write
+///
+/// @retval  None
+///
+//==============================================================================
+#if defined(__GNUC__)
+    __attribute__((optimize("-O0")))
+#endif
+PAC5XXX_RAMFUNC void flash_write_row(uint32_t *p_dest, const uint32_t *p_src)
+{
+    uint8_t i;
+
+    // Clear WRITEWORDCNT in case it's not 0; must set FLASHLOCK to allow write to MEMCTL
+    PAC55XX_MEMCTL->FLASHLOCK = FLASH_LOCK_ALLOW_WRITE_MEMCTL;
+    PAC55XX_MEMCTL->MEMCTL.WRITEWORDCNT = 0;
+
+    // Set FLASHLOCK to allow Writes to Flash
+    PAC55XX_MEMCTL->FLASHLOCK = FLASH_LOCK_ALLOW_WRITE_ERASE_FLASH;
+
+    for(i=0; i < 4; i++)
+    {
+        *p_dest++ = p_src[i];
+    }
+
+    // Reads or fetches from Flash must wait for WBUSY=0 and a further 10uS
+    while(PAC55XX_MEMCTL->MEMSTATUS.WBUSY) { }
+    pac_delay_asm_ramfunc(160);                 // delay 10uS after WBUSY=0
+
+    // Return FLASHLOCK to locked state
+    PAC55XX_MEMCTL->FLASHLOCK =0;
+}
@@ -22,4 +22,5 @@ extern void flash_erase_page(uint32_t page_num);
 extern void flash_erase_key(uint32_t key);
 extern void flash_write(uint8_t *p_dest, uint8_t *p_src, uint32_t size_bytes);
 extern void flash_write_word(uint32_t * p_dest, uint32_t value);
+extern void flash_write_row(uint32_t *p_dest, const uint32_t *p_src);
 #endif
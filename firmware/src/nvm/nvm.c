@@ -15,6 +15,7 @@
 //  * along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include <string.h>
+#include <stddef.h>
 #include <src/common.h>
 #include <src/system/system.h>
 #include <src/nvm/flash_func.h>
@@ -24,16 +25,118 @@ static struct NVMStruct s;
 
 const uint32_t config_size = sizeof(struct NVMStruct);
 
+// Stored config sections. Bump the version of a section whenever its
+// struct changes. Stored versions from min_version onwards are loaded
+// into the current struct by their common prefix, which is valid as
+// long as fields are only appended; newer fields keep their defaults.
+// Bumping min_version as well discards older stored sections, which
+// then revert to defaults.
+typedef struct {
+    uint8_t tag;
+    uint8_t version;
+    uint8_t min_version;
+    uint16_t offset;            // Within struct NVMStruct
+    uint16_t size;
+} NVMSection;
+
+#define NVM_SECTION(tag_, member, version_, min_version_) \
+    {tag_, version_, min_version_, offsetof(struct NVMStruct, member), sizeof(((struct NVMStruct *)0)->member)}
+
+static const NVMSection nvm_sections[] = {
+    NVM_SECTION(NVM_TAG_VERSION, version, 1, 1),
+    NVM_SECTION(NVM_TAG_FRAMES, frames_config, 1, 1),
+    NVM_SECTION(NVM_TAG_ADC, adc_config, 1, 1),
+    NVM_SECTION(NVM_TAG_MOTOR, motor_config, 1, 1),
+    NVM_SECTION(NVM_TAG_SENSORS, sensors_config, 1, 1),
+    NVM_SECTION(NVM_TAG_OBSERVERS, observers_config, 1, 1),
+    NVM_SECTION(NVM_TAG_CONTROLLER, controller_config, 1, 1),
+    NVM_SECTION(NVM_TAG_CAN, can_config, 2, 1),
+    NVM_SECTION(NVM_TAG_TRAJ_PLANNER, traj_planner_config, 1, 1),
+};
+
+#define NVM_SECTION_COUNT (sizeof(nvm_sections) / sizeof(nvm_sections[0]))
+
 // Wear leveling state (RAM only, reconstructed on boot)
 typedef struct {
     uint8_t current_slot;      // Index of most recent valid config
-    uint32_t latest_sequence;  // Sequence number of current_slot
-    uint8_t next_write_slot;   // Where next write will go
+    uint32_t latest_sequence;  // Sequence number of the latest write
+    uint8_t next_write_slot;   // Where next full write will go
+    uint8_t erased_slots;      // Slots known to be blank
+    uint16_t log_end;          // Where the next record goes in current_slot
+    bool sections_known;       // Whether section_crc matches the stored sections
+    uint32_t section_crc[NVM_SECTION_COUNT];  // Of the stored sections, by table index
     bool initialized;          // Has scan completed?
 } NVMWearLevelingState;
 
 static NVMWearLevelingState wl_state = {0};
 
+_Static_assert(NVM_NUM_SLOTS <= 8, "Slots must fit in the erased slots mask");
+
+// A save writes the full config to a fresh slot, or appends a record of
+// the sections changed since to the current slot if there is room. Slots
+// are only erased once their log is full, which saves erase cycles when
+// a few small sections are saved often.
+//
+// A save request only copies the config into RAM. The rest proceeds in
+// steps that run in the idle time of control cycles: the CRCs of the
+// sections and of the payload in chunks of NVM_PREPARE_CHUNK_SIZE bytes,
+// the serialization one section at a time, then one page erase or one
+// row write at a time. Preparation steps and row writes only run if
+// they complete before the next control cycle. Flash must not be read
+// while it is being written, and the vector table and interrupt
+// handlers reside in flash, so interrupts are masked for each write or
+// erase. Each row is checked to be blank just before it is written.
+// Pages are only erased while the controller is idle, as an erase
+// stalls the processor for milliseconds; the next slot is erased in
+// advance after each save, so that the following save only writes.
+// This happens within the save if the controller is idle, otherwise
+// once it becomes idle.
+typedef enum {
+    NVM_PREPARE_CRC = 0,       // Section CRCs, to find the changed sections
+    NVM_PREPARE_SERIALIZE,     // Sections into save_buffer
+    NVM_PREPARE_CHECKSUM       // Payload CRC-32
+} NVMPreparePhase;
+
+typedef struct {
+    nvm_save_state_options state;
+    NVMPreparePhase phase;
+    uint8_t section;           // Table index of the section being prepared
+    uint16_t pos;              // Bytes done of the section or payload being checksummed
+    uint16_t payload_size;     // Serialized so far
+    uint32_t crc;              // Running CRC-32
+    uint32_t changed;          // Sections changed since stored, by table index
+    bool full;                 // Full config to a fresh slot, rather than a record
+    uint32_t prepare_cycles;   // Longest preparation step so far, in processor cycles
+    uint8_t slot;
+    uint8_t page;              // Next page of the slot to erase
+    uint16_t offset;           // Of the write within the slot
+    uint16_t row;              // Rows written so far
+    uint16_t row_count;
+    uint8_t header_rows;       // Written last, to validate the rest
+    uint32_t row_cycles;       // Longest row write so far, in processor cycles
+    uint32_t sequence;
+    bool restart;              // Save again with a fresh snapshot once done
+    bool preerase;             // Erase the next slot once idle
+    uint32_t section_crc[NVM_SECTION_COUNT];  // Of the sections being saved
+} NVMSaveState;
+
+static NVMSaveState save_state = {
+    .state = NVM_SAVE_STATE_IDLE,
+    .prepare_cycles = NVM_PREPARE_CYCLES_INIT,
+    .row_cycles = NVM_ROW_WRITE_CYCLES_INIT
+};
+
+// Snapshot of metadata and sections being written, padded to whole rows
+static uint32_t save_buffer[DIVIDE_AND_ROUND_UP(NVM_METADATA_SIZE + NVM_PAYLOAD_MAX_SIZE, NVM_ROW_SIZE) * NVM_ROW_SIZE / sizeof(uint32_t)];
+
+#define NVM_SECTION_BIT(tag) (1u << (tag))
+#define NVM_ALIGN4(n) (((n) + 3u) & ~3u)
+#define NVM_ALIGN_ROW(n) (((n) + (NVM_ROW_SIZE - 1u)) & ~(NVM_ROW_SIZE - 1u))
+
+_Static_assert(NVM_TAG_MAX <= 32, "Section tags must fit in the loaded sections mask");
+_Static_assert(NVM_SECTION_COUNT <= 32, "Sections must fit in the changed sections mask");
+
+// Byte sum, used by the legacy formats only
 uint32_t calculate_checksum(const uint8_t *data, size_t len)
 {
     uint32_t checksum = 0;
@@ -44,13 +147,234 @@ uint32_t calculate_checksum(const uint8_t *data, size_t len)
     return ~checksum + 1;
 }
 
-bool nvm_save_config(void)
+// CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320), as in zlib
+static const uint32_t crc32_table[256] = {
+    0x00000000u, 0x77073096u, 0xEE0E612Cu, 0x990951BAu, 0x076DC419u, 0x706AF48Fu,
+    0xE963A535u, 0x9E6495A3u, 0x0EDB8832u, 0x79DCB8A4u, 0xE0D5E91Eu, 0x97D2D988u,
+    0x09B64C2Bu, 0x7EB17CBDu, 0xE7B82D07u, 0x90BF1D91u, 0x1DB71064u, 0x6AB020F2u,
+    0xF3B97148u, 0x84BE41DEu, 0x1ADAD47Du, 0x6DDDE4EBu, 0xF4D4B551u, 0x83D385C7u,
+    0x136C9856u, 0x646BA8C0u, 0xFD62F97Au, 0x8A65C9ECu, 0x14015C4Fu, 0x63066CD9u,
+    0xFA0F3D63u, 0x8D080DF5u, 0x3B6E20C8u, 0x4C69105Eu, 0xD56041E4u, 0xA2677172u,
+    0x3C03E4D1u, 0x4B04D447u, 0xD20D85FDu, 0xA50AB56Bu, 0x35B5A8FAu, 0x42B2986Cu,
+    0xDBBBC9D6u, 0xACBCF940u, 0x32D86CE3u, 0x45DF5C75u, 0xDCD60DCFu, 0xABD13D59u,
+    0x26D930ACu, 0x51DE003Au, 0xC8D75180u, 0xBFD06116u, 0x21B4F4B5u, 0x56B3C423u,
+    0xCFBA9599u, 0xB8BDA50Fu, 0x2802B89Eu, 0x5F058808u, 0xC60CD9B2u, 0xB10BE924u,
+    0x2F6F7C87u, 0x58684C11u, 0xC1611DABu, 0xB6662D3Du, 0x76DC4190u, 0x01DB7106u,
+    0x98D220BCu, 0xEFD5102Au, 0x71B18589u, 0x06B6B51Fu, 0x9FBFE4A5u, 0xE8B8D433u,
+    0x7807C9A2u, 0x0F00F934u, 0x9609A88Eu, 0xE10E9818u, 0x7F6A0DBBu, 0x086D3D2Du,
+    0x91646C97u, 0xE6635C01u, 0x6B6B51F4u, 0x1C6C6162u, 0x856530D8u, 0xF262004Eu,
+    0x6C0695EDu, 0x1B01A57Bu, 0x8208F4C1u, 0xF50FC457u, 0x65B0D9C6u, 0x12B7E950u,
+    0x8BBEB8EAu, 0xFCB9887Cu, 0x62DD1DDFu, 0x15DA2D49u, 0x8CD37CF3u, 0xFBD44C65u,
+    0x4DB26158u, 0x3AB551CEu, 0xA3BC0074u, 0xD4BB30E2u, 0x4ADFA541u, 0x3DD895D7u,
+    0xA4D1C46Du, 0xD3D6F4FBu, 0x4369E96Au, 0x346ED9FCu, 0xAD678846u, 0xDA60B8D0u,
+    0x44042D73u, 0x33031DE5u, 0xAA0A4C5Fu, 0xDD0D7CC9u, 0x5005713Cu, 0x270241AAu,
+    0xBE0B1010u, 0xC90C2086u, 0x5768B525u, 0x206F85B3u, 0xB966D409u, 0xCE61E49Fu,
+    0x5EDEF90Eu, 0x29D9C998u, 0xB0D09822u, 0xC7D7A8B4u, 0x59B33D17u, 0x2EB40D81u,
+    0xB7BD5C3Bu, 0xC0BA6CADu, 0xEDB88320u, 0x9ABFB3B6u, 0x03B6E20Cu, 0x74B1D29Au,
+    0xEAD54739u, 0x9DD277AFu, 0x04DB2615u, 0x73DC1683u, 0xE3630B12u, 0x94643B84u,
+    0x0D6D6A3Eu, 0x7A6A5AA8u, 0xE40ECF0Bu, 0x9309FF9Du, 0x0A00AE27u, 0x7D079EB1u,
+    0xF00F9344u, 0x8708A3D2u, 0x1E01F268u, 0x6906C2FEu, 0xF762575Du, 0x806567CBu,
+    0x196C3671u, 0x6E6B06E7u, 0xFED41B76u, 0x89D32BE0u, 0x10DA7A5Au, 0x67DD4ACCu,
+    0xF9B9DF6Fu, 0x8EBEEFF9u, 0x17B7BE43u, 0x60B08ED5u, 0xD6D6A3E8u, 0xA1D1937Eu,
+    0x38D8C2C4u, 0x4FDFF252u, 0xD1BB67F1u, 0xA6BC5767u, 0x3FB506DDu, 0x48B2364Bu,
+    0xD80D2BDAu, 0xAF0A1B4Cu, 0x36034AF6u, 0x41047A60u, 0xDF60EFC3u, 0xA867DF55u,
+    0x316E8EEFu, 0x4669BE79u, 0xCB61B38Cu, 0xBC66831Au, 0x256FD2A0u, 0x5268E236u,
+    0xCC0C7795u, 0xBB0B4703u, 0x220216B9u, 0x5505262Fu, 0xC5BA3BBEu, 0xB2BD0B28u,
+    0x2BB45A92u, 0x5CB36A04u, 0xC2D7FFA7u, 0xB5D0CF31u, 0x2CD99E8Bu, 0x5BDEAE1Du,
+    0x9B64C2B0u, 0xEC63F226u, 0x756AA39Cu, 0x026D930Au, 0x9C0906A9u, 0xEB0E363Fu,
+    0x72076785u, 0x05005713u, 0x95BF4A82u, 0xE2B87A14u, 0x7BB12BAEu, 0x0CB61B38u,
+    0x92D28E9Bu, 0xE5D5BE0Du, 0x7CDCEFB7u, 0x0BDBDF21u, 0x86D3D2D4u, 0xF1D4E242u,
+    0x68DDB3F8u, 0x1FDA836Eu, 0x81BE16CDu, 0xF6B9265Bu, 0x6FB077E1u, 0x18B74777u,
+    0x88085AE6u, 0xFF0F6A70u, 0x66063BCAu, 0x11010B5Cu, 0x8F659EFFu, 0xF862AE69u,
+    0x616BFFD3u, 0x166CCF45u, 0xA00AE278u, 0xD70DD2EEu, 0x4E048354u, 0x3903B3C2u,
+    0xA7672661u, 0xD06016F7u, 0x4969474Du, 0x3E6E77DBu, 0xAED16A4Au, 0xD9D65ADCu,
+    0x40DF0B66u, 0x37D83BF0u, 0xA9BCAE53u, 0xDEBB9EC5u, 0x47B2CF7Fu, 0x30B5FFE9u,
+    0xBDBDF21Cu, 0xCABAC28Au, 0x53B39330u, 0x24B4A3A6u, 0xBAD03605u, 0xCDD70693u,
+    0x54DE5729u, 0x23D967BFu, 0xB3667A2Eu, 0xC4614AB8u, 0x5D681B02u, 0x2A6F2B94u,
+    0xB40BBE37u, 0xC30C8EA1u, 0x5A05DF1Bu, 0x2D02EF8Du
+};
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len)
 {
-    // Ensure wear leveling is initialized
-    if (!wl_state.initialized)
+    for (size_t i = 0; i < len; ++i)
     {
-        nvm_wl_scan_slots();
+        crc = crc32_table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
     }
+    return crc;
+}
+
+uint32_t calculate_crc32(const uint8_t *data, size_t len)
+{
+    return ~crc32_update(0xFFFFFFFFu, data, len);
+}
+
+// Checksum used by a given metadata version
+static uint32_t nvm_checksum(uint16_t metadata_version, const uint8_t *data, size_t len)
+{
+    if (metadata_version >= NVM_METADATA_VERSION_CRC)
+    {
+        return calculate_crc32(data, len);
+    }
+    return calculate_checksum(data, len);
+}
+
+// Collects the runtime config of all modules into the RAM copy
+static void nvm_collect_config(void)
+{
+    s.node_id_1 = CAN_get_ID();
+    s.node_id_2 = CAN_get_ID();
+    frames_get_config(&(s.frames_config));
+    s.adc_config = *ADC_get_config();
+    s.motor_config = *motor_get_config();
+    sensors_get_config(&(s.sensors_config));
+    observers_get_config(&(s.observers_config));
+    s.controller_config = *controller_get_config();
+    s.can_config = *CAN_get_config();
+    s.traj_planner_config = *traj_planner_get_config();
+    strncpy(s.version, GIT_VERSION, sizeof(s.version));
+}
+
+// Writes a section of the RAM copy as a tagged record, its data padded
+// to 4 bytes. Returns the length written.
+static uint16_t nvm_serialize_section(uint8_t *buffer, const NVMSection *section)
+{
+    const NVMSectionHeader header = {
+        .tag = section->tag,
+        .version = section->version,
+        .length = section->size
+    };
+    memcpy(buffer, &header, sizeof(header));
+    memset(buffer + sizeof(header), 0, NVM_ALIGN4(section->size));
+    memcpy(buffer + sizeof(header), (const uint8_t *)&s + section->offset, section->size);
+    return sizeof(header) + NVM_ALIGN4(section->size);
+}
+
+// Length of the sections in mask (by table index) as serialized,
+// followed by an end marker and a checksum
+static uint16_t nvm_serialized_size(uint32_t mask)
+{
+    uint16_t size = sizeof(NVMSectionHeader) + sizeof(uint32_t);
+    for (uint32_t i = 0; i < NVM_SECTION_COUNT; i++)
+    {
+        if (mask & (1u << i))
+        {
+            size += sizeof(NVMSectionHeader) + NVM_ALIGN4(nvm_sections[i].size);
+        }
+    }
+    return size;
+}
+
+// Whether a payload of tagged sections matches its trailing checksum
+static bool nvm_sections_valid(uint16_t metadata_version, const uint8_t *payload, uint16_t size)
+{
+    if (size < sizeof(NVMSectionHeader) + sizeof(uint32_t))
+    {
+        return false;
+    }
+    const uint16_t body_size = size - sizeof(uint32_t);
+    uint32_t stored_checksum;
+    memcpy(&stored_checksum, payload + body_size, sizeof(stored_checksum));
+    return nvm_checksum(metadata_version, payload, body_size) == stored_checksum;
+}
+
+// Loads the tagged records of a validated payload into the RAM copy,
+// which should hold defaults beforehand, and keeps the CRC-32 of each
+// loaded section. Returns a mask of the sections loaded, by tag.
+static uint32_t nvm_deserialize_sections(const uint8_t *payload, uint16_t size)
+{
+    const uint16_t body_size = size - sizeof(uint32_t);
+    uint32_t loaded = 0;
+    uint16_t pos = 0;
+    while (pos + sizeof(NVMSectionHeader) <= body_size)
+    {
+        NVMSectionHeader header;
+        memcpy(&header, payload + pos, sizeof(header));
+        pos += sizeof(header);
+        if ((header.tag == NVM_TAG_END) || (pos + NVM_ALIGN4(header.length) > body_size))
+        {
+            break;
+        }
+        for (uint32_t i = 0; i < NVM_SECTION_COUNT; i++)
+        {
+            const NVMSection *section = &(nvm_sections[i]);
+            if ((section->tag == header.tag)
+                && (header.version >= section->min_version)
+                && (header.version <= section->version))
+            {
+                const uint16_t len = header.length < section->size ? header.length : section->size;
+                memcpy((uint8_t *)&s + section->offset, payload + pos, len);
+                loaded |= NVM_SECTION_BIT(header.tag);
+                wl_state.section_crc[i] = calculate_crc32(payload + pos - sizeof(header),
+                    sizeof(header) + header.length);
+            }
+        }
+        // Unknown tags and versions are skipped, keeping defaults
+        pos += NVM_ALIGN4(header.length);
+    }
+    return loaded;
+}
+
+static bool nvm_is_blank(uint8_t slot, uint16_t offset, uint16_t size)
+{
+    const uint32_t *p = (const uint32_t *)(SETTINGS_PAGE_HEX + (slot * NVM_SLOT_BYTES) + offset);
+    for (uint32_t i = 0; i < size / sizeof(uint32_t); i++)
+    {
+        if (p[i] != 0xFFFFFFFFu)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool nvm_record_header_valid(const NVMRecordHeader *header, uint16_t pos)
+{
+    return (header->magic_marker == NVM_RECORD_MARKER)
+        && (header->checksum == calculate_crc32((const uint8_t *)header, sizeof(NVMRecordHeader) - sizeof(header->checksum)))
+        && (pos + NVM_ALIGN_ROW(sizeof(NVMRecordHeader) + header->data_size) <= NVM_SLOT_BYTES);
+}
+
+static uint32_t nvm_next_sequence(void)
+{
+    // Sequence number 0 stands for no valid config, and is skipped on wraparound
+    const uint32_t sequence = wl_state.latest_sequence + 1;
+    return sequence == 0 ? 1 : sequence;
+}
+
+// Header size of the slot or record being saved, where its payload starts
+static uint16_t nvm_save_header_size(void)
+{
+    return save_state.full ? NVM_METADATA_SIZE : sizeof(NVMRecordHeader);
+}
+
+// Starts preparing a save of the RAM copy
+static void nvm_save_start(void)
+{
+    save_state.state = NVM_SAVE_STATE_PREPARING;
+    save_state.phase = NVM_PREPARE_CRC;
+    save_state.section = 0;
+    save_state.pos = 0;
+    save_state.changed = 0;
+    save_state.restart = false;
+}
+
+static void nvm_prepare_serialize_start(bool full)
+{
+    save_state.state = NVM_SAVE_STATE_PREPARING;
+    save_state.phase = NVM_PREPARE_SERIALIZE;
+    save_state.full = full;
+    save_state.section = 0;
+    save_state.payload_size = 0;
+}
+
+// Selects where to write once the changed sections are known: a record
+// of them appended to the current slot if it has room, otherwise the
+// full config to the next slot
+static void nvm_prepare_select(void)
+{
+    // A record can only be appended to a valid slot whose stored
+    // sections are known
+    bool full = !wl_state.sections_known;
 
     // Check if node ID has changed - if so, force write to slot 0
     // This ensures slot 0 always contains the current CAN ID
@@ -67,77 +391,394 @@ bool nvm_save_config(void)
             current_metadata->node_id_2 != current_node_id)
         {
             wl_state.next_write_slot = 0;
+            full = true;
         }
     }
     else
     {
         // No valid config yet, write to slot 0
         wl_state.next_write_slot = 0;
+        full = true;
     }
 
-    // Prepare combined buffer: [Metadata 16B][NVMStruct]
-    uint8_t data[NVM_METADATA_SIZE + sizeof(struct NVMStruct)];
-    uint8_t readback_data[NVM_METADATA_SIZE + sizeof(struct NVMStruct)];
-
-    // Prepare metadata
-    NVMMetadata *metadata = (NVMMetadata *)data;
-    nvm_wl_prepare_metadata(metadata, sizeof(struct NVMStruct));
-
-    // Prepare config data (existing logic)
-    struct NVMStruct *config = (struct NVMStruct *)(data + NVM_METADATA_SIZE);
-    config->node_id_1 = CAN_get_ID();
-    config->node_id_2 = CAN_get_ID();
-    frames_get_config(&(config->frames_config));
-    config->adc_config = *ADC_get_config();
-    config->motor_config = *motor_get_config();
-    sensors_get_config(&(config->sensors_config));
-    observers_get_config(&(config->observers_config));
-    config->controller_config = *controller_get_config();
-    config->can_config = *CAN_get_config();
-    config->traj_planner_config = *traj_planner_get_config();
-    strncpy(config->version, GIT_VERSION, sizeof(config->version));
-
-    // Calculate config checksum
-    uint8_t *config_bytes = (uint8_t *)config;
-    config->checksum = calculate_checksum(config_bytes,
-        sizeof(struct NVMStruct) - sizeof(config->checksum));
+    if (!full && !save_state.changed)
+    {
+        // Nothing changed since the last save
+        save_state.state = NVM_SAVE_STATE_IDLE;
+        return;
+    }
+    if (!full)
+    {
+        const uint16_t size = NVM_ALIGN_ROW(sizeof(NVMRecordHeader) + nvm_serialized_size(save_state.changed));
+        full = (wl_state.log_end + size > NVM_SLOT_BYTES);
+    }
+    nvm_prepare_serialize_start(full);
+}
 
-    if (CONTROLLER_STATE_IDLE == controller_get_state())
+// Computes the CRC-32 of the next chunk of a section as it would be
+// stored, header included, to tell which sections changed since they
+// were stored
+static void nvm_prepare_crc_step(void)
+{
+    const NVMSection *section = &(nvm_sections[save_state.section]);
+    if (save_state.pos == 0)
+    {
+        const NVMSectionHeader header = {
+            .tag = section->tag,
+            .version = section->version,
+            .length = section->size
+        };
+        save_state.crc = crc32_update(0xFFFFFFFFu, (const uint8_t *)&header, sizeof(header));
+    }
+    const uint16_t remaining = section->size - save_state.pos;
+    const uint16_t len = remaining < NVM_PREPARE_CHUNK_SIZE ? remaining : NVM_PREPARE_CHUNK_SIZE;
+    save_state.crc = crc32_update(save_state.crc, (const uint8_t *)&s + section->offset + save_state.pos, len);
+    save_state.pos += len;
+    if (save_state.pos < section->size)
     {
-        // Calculate target slot address
-        uint32_t slot_addr = SETTINGS_PAGE_HEX +
-            (wl_state.next_write_slot * NVM_SLOT_BYTES);
+        return;
+    }
+    save_state.section_crc[save_state.section] = ~save_state.crc;
+    if (save_state.section_crc[save_state.section] != wl_state.section_crc[save_state.section])
+    {
+        save_state.changed |= (1u << save_state.section);
+    }
+    save_state.pos = 0;
+    save_state.section++;
+    if (save_state.section == NVM_SECTION_COUNT)
+    {
+        nvm_prepare_select();
+    }
+}
 
-        __disable_irq();
+// Serializes the next section to be saved. Once all are done, appends
+// the end marker.
+static void nvm_prepare_serialize_step(void)
+{
+    uint8_t *payload = (uint8_t *)save_buffer + nvm_save_header_size();
+    const uint32_t mask = save_state.full ? ((1u << NVM_SECTION_COUNT) - 1u) : save_state.changed;
+    while ((save_state.section < NVM_SECTION_COUNT) && !(mask & (1u << save_state.section)))
+    {
+        save_state.section++;
+    }
+    if (save_state.section < NVM_SECTION_COUNT)
+    {
+        save_state.payload_size += nvm_serialize_section(payload + save_state.payload_size,
+            &(nvm_sections[save_state.section]));
+        save_state.section++;
+        return;
+    }
+    const NVMSectionHeader end = {.tag = NVM_TAG_END, .version = 0, .length = 0};
+    memcpy(payload + save_state.payload_size, &end, sizeof(end));
+    save_state.payload_size += sizeof(end);
+    save_state.phase = NVM_PREPARE_CHECKSUM;
+    save_state.pos = 0;
+    save_state.crc = 0xFFFFFFFFu;
+}
 
-        // Erase only the target slot pages (generic: adapts to slot size)
-        for (uint8_t i = 0; i < NVM_SLOT_SIZE; i++)
+// Adds the metadata or record header to the serialized payload, and
+// selects the rows to write
+static void nvm_prepare_finish(void)
+{
+    uint8_t *data = (uint8_t *)save_buffer;
+    const uint16_t header_size = nvm_save_header_size();
+    const uint16_t size = NVM_ALIGN_ROW(header_size + save_state.payload_size);
+    // Pad the last row with the erased flash value
+    memset(data + header_size + save_state.payload_size, 0xFF, size - header_size - save_state.payload_size);
+    if (save_state.full)
+    {
+        // [Metadata 32B][All sections] to the next slot
+        nvm_wl_prepare_metadata((NVMMetadata *)data, save_state.payload_size);
+        save_state.sequence = ((NVMMetadata *)data)->sequence_number;
+        save_state.slot = wl_state.next_write_slot;
+        save_state.offset = 0;
+    }
+    else
+    {
+        // [Record header 16B][Changed sections] to the log
+        NVMRecordHeader *header = (NVMRecordHeader *)data;
+        header->sequence_number = nvm_next_sequence();
+        header->magic_marker = NVM_RECORD_MARKER;
+        header->data_size = save_state.payload_size;
+        header->reserved = 0;
+        header->checksum = calculate_crc32(data, sizeof(NVMRecordHeader) - sizeof(header->checksum));
+        save_state.sequence = header->sequence_number;
+        save_state.slot = wl_state.current_slot;
+        save_state.offset = wl_state.log_end;
+    }
+    save_state.row_count = size / NVM_ROW_SIZE;
+    save_state.header_rows = header_size / NVM_ROW_SIZE;
+    save_state.row = 0;
+    save_state.page = 0;
+    save_state.preerase = false;
+    save_state.state = NVM_SAVE_STATE_WRITING;
+}
+
+// Computes the payload checksum in chunks, then appends it
+static void nvm_prepare_checksum_step(void)
+{
+    uint8_t *payload = (uint8_t *)save_buffer + nvm_save_header_size();
+    const uint16_t remaining = save_state.payload_size - save_state.pos;
+    const uint16_t len = remaining < NVM_PREPARE_CHUNK_SIZE ? remaining : NVM_PREPARE_CHUNK_SIZE;
+    save_state.crc = crc32_update(save_state.crc, payload + save_state.pos, len);
+    save_state.pos += len;
+    if (save_state.pos < save_state.payload_size)
+    {
+        return;
+    }
+    const uint32_t checksum = ~save_state.crc;
+    memcpy(payload + save_state.payload_size, &checksum, sizeof(checksum));
+    save_state.payload_size += sizeof(checksum);
+    nvm_prepare_finish();
+}
+
+static void nvm_save_prepare_step(void)
+{
+    switch (save_state.phase)
+    {
+        case NVM_PREPARE_CRC:
+            nvm_prepare_crc_step();
+            break;
+        case NVM_PREPARE_SERIALIZE:
+            nvm_prepare_serialize_step();
+            break;
+        default:
+            nvm_prepare_checksum_step();
+            break;
+    }
+}
+
+static void nvm_save_complete(void)
+{
+    wl_state.current_slot = save_state.slot;
+    wl_state.latest_sequence = save_state.sequence;
+    wl_state.next_write_slot = (save_state.slot + 1) % NVM_NUM_SLOTS;
+    wl_state.log_end = save_state.offset + save_state.row_count * NVM_ROW_SIZE;
+    memcpy(wl_state.section_crc, save_state.section_crc, sizeof(wl_state.section_crc));
+    wl_state.sections_known = true;
+    save_state.state = NVM_SAVE_STATE_IDLE;
+    save_state.preerase = !(wl_state.erased_slots & (1u << wl_state.next_write_slot));
+    save_state.slot = wl_state.next_write_slot;
+    save_state.page = 0;
+    if (save_state.restart)
+    {
+        // The config was copied again when the save was requested
+        nvm_save_start();
+    }
+}
+
+// Erases the next page of the slot, while the controller is idle
+static bool nvm_save_erase_step(void)
+{
+    if (CONTROLLER_STATE_IDLE != controller_get_state())
+    {
+        return false;
+    }
+    __disable_irq();
+    flash_erase_page(SETTINGS_PAGE + save_state.slot * NVM_SLOT_SIZE + save_state.page);
+    __enable_irq();
+    save_state.page++;
+    if (save_state.page == NVM_SLOT_SIZE)
+    {
+        wl_state.erased_slots |= (1u << save_state.slot);
+        return true;
+    }
+    return false;
+}
+
+// Writes and verifies the next row. The metadata or record header rows
+// are written last, so that a slot or record only becomes valid once
+// completely written. A row that is not blank means the slot needs
+// erasing, or for a record that the full config must be written instead.
+static void nvm_save_write_step(void)
+{
+    const uint16_t row = (save_state.row + save_state.header_rows) % save_state.row_count;
+    const uint32_t offset = row * NVM_ROW_SIZE;
+    uint32_t *dest = (uint32_t *)(SETTINGS_PAGE_HEX + (save_state.slot * NVM_SLOT_BYTES)
+        + save_state.offset + offset);
+    const uint32_t *src = save_buffer + (offset / sizeof(uint32_t));
+
+    if (!nvm_is_blank(save_state.slot, save_state.offset + offset, NVM_ROW_SIZE))
+    {
+        if (save_state.full)
+        {
+            wl_state.erased_slots &= ~(1u << save_state.slot);
+            save_state.page = 0;
+            save_state.row = 0;
+            save_state.state = NVM_SAVE_STATE_ERASING;
+        }
+        else
         {
-            flash_erase_page(SETTINGS_PAGE + wl_state.next_write_slot * NVM_SLOT_SIZE + i);
+            nvm_prepare_serialize_start(true);
         }
+        return;
+    }
 
-        // Write metadata + config
-        flash_write((uint8_t *)slot_addr, data,
-            NVM_METADATA_SIZE + sizeof(struct NVMStruct));
+    wl_state.erased_slots &= ~(1u << save_state.slot);
+    const uint32_t start = DWT->CYCCNT;
+    __disable_irq();
+    flash_write_row(dest, src);
+    __enable_irq();
+    const uint32_t cycles = DWT->CYCCNT - start;
+    if (cycles > save_state.row_cycles)
+    {
+        save_state.row_cycles = cycles;
+    }
 
-        __enable_irq();
+    if (memcmp(dest, src, NVM_ROW_SIZE) != 0)
+    {
+        save_state.state = NVM_SAVE_STATE_FAILED;
+        return;
+    }
+    save_state.row++;
+    if (save_state.row == save_state.row_count)
+    {
+        nvm_save_complete();
+    }
+}
 
-        // Verify write
-        memcpy(readback_data, (uint8_t *)slot_addr,
-            NVM_METADATA_SIZE + sizeof(struct NVMStruct));
-        if (memcmp(data, readback_data,
-            NVM_METADATA_SIZE + sizeof(struct NVMStruct)) == 0)
-        {
-            // Update wear leveling state
-            wl_state.current_slot = wl_state.next_write_slot;
-            wl_state.latest_sequence = metadata->sequence_number;
-            wl_state.next_write_slot = (wl_state.next_write_slot + 1) % NVM_NUM_SLOTS;
+// Performs a single save step. Unless forced, preparation steps and row
+// writes run only if they complete before the next control cycle.
+static void nvm_save_step(uint32_t cycles_elapsed, bool force)
+{
+    switch (save_state.state)
+    {
+        case NVM_SAVE_STATE_PREPARING:
+            if (force || (CONTROLLER_STATE_IDLE == controller_get_state())
+                || (cycles_elapsed + save_state.prepare_cycles + NVM_ROW_MARGIN_CYCLES < NVM_CONTROL_CYCLE_CYCLES))
+            {
+                const uint32_t start = DWT->CYCCNT;
+                nvm_save_prepare_step();
+                const uint32_t cycles = DWT->CYCCNT - start;
+                if (cycles > save_state.prepare_cycles)
+                {
+                    save_state.prepare_cycles = cycles;
+                }
+            }
+            break;
+        case NVM_SAVE_STATE_WAITING:
+        case NVM_SAVE_STATE_ERASING:
+            if (nvm_save_erase_step())
+            {
+                save_state.state = NVM_SAVE_STATE_WRITING;
+            }
+            else
+            {
+                save_state.state = (CONTROLLER_STATE_IDLE == controller_get_state()) ?
+                    NVM_SAVE_STATE_ERASING : NVM_SAVE_STATE_WAITING;
+            }
+            break;
+        case NVM_SAVE_STATE_WRITING:
+            if (force || (CONTROLLER_STATE_IDLE == controller_get_state())
+                || (cycles_elapsed + save_state.row_cycles + NVM_ROW_MARGIN_CYCLES < NVM_CONTROL_CYCLE_CYCLES))
+            {
+                nvm_save_write_step();
+            }
+            break;
+        default:
+            if (save_state.preerase && nvm_save_erase_step())
+            {
+                save_state.preerase = false;
+            }
+            break;
+    }
+}
+
+bool nvm_save_config(void)
+{
+    // Ensure wear leveling is initialized
+    if (!wl_state.initialized)
+    {
+        nvm_wl_scan_slots();
+    }
 
-            // Also update RAM copy for consistency
-            s = *config;
+    // Snapshot of the config. The buffer being written holds the
+    // previous snapshot serialized, so it is not affected.
+    nvm_collect_config();
+    if ((NVM_SAVE_STATE_WAITING == save_state.state)
+        || (NVM_SAVE_STATE_ERASING == save_state.state)
+        || (NVM_SAVE_STATE_WRITING == save_state.state))
+    {
+        // Rows already written can't be rewritten without erasing again
+        save_state.restart = true;
+    }
+    else
+    {
+        // A save still being prepared starts over from the new snapshot
+        nvm_save_start();
+    }
 
-            return true;
+    if (CONTROLLER_STATE_IDLE == controller_get_state())
+    {
+        // Complete the save right away, as there's no control to keep up.
+        // The next slot is erased here too, so that interrupts are only
+        // masked while the host waits for the save.
+        while ((NVM_SAVE_STATE_PREPARING == save_state.state)
+            || (NVM_SAVE_STATE_ERASING == save_state.state)
+            || (NVM_SAVE_STATE_WRITING == save_state.state)
+            || ((NVM_SAVE_STATE_IDLE == save_state.state) && save_state.preerase))
+        {
+            nvm_save_step(0, true);
         }
+        return NVM_SAVE_STATE_IDLE == save_state.state;
+    }
+    return true;
+}
+
+void nvm_save_update(uint32_t cycles_elapsed)
+{
+    nvm_save_step(cycles_elapsed, false);
+}
+
+bool nvm_save_pending(void)
+{
+    return (NVM_SAVE_STATE_PREPARING == save_state.state)
+        || (NVM_SAVE_STATE_WAITING == save_state.state)
+        || (NVM_SAVE_STATE_ERASING == save_state.state)
+        || (NVM_SAVE_STATE_WRITING == save_state.state)
+        || save_state.preerase;
+}
+
+nvm_save_state_options nvm_get_save_state(void)
+{
+    return save_state.state;
+}
+
+uint8_t nvm_get_save_progress(void)
+{
+    switch (save_state.state)
+    {
+        case NVM_SAVE_STATE_PREPARING:
+        case NVM_SAVE_STATE_WAITING:
+        case NVM_SAVE_STATE_ERASING:
+            return 0;
+        case NVM_SAVE_STATE_WRITING:
+            return (uint8_t)((100u * save_state.row) / save_state.row_count);
+        case NVM_SAVE_STATE_FAILED:
+            return 0;
+        default:
+            return 100;
+    }
+}
+
+// Loads a config written as a raw NVMStruct by earlier firmware. Its
+// layout is only known to match if the firmware version is the same.
+static bool nvm_load_raw_config(const uint8_t *payload)
+{
+    memcpy(&s, payload, sizeof(struct NVMStruct));
+
+    // Validate version
+    if (strncmp(s.version, GIT_VERSION, sizeof(s.version)) == 0)
+    {
+        frames_restore_config(&s.frames_config);
+        ADC_restore_config(&s.adc_config);
+        motor_restore_config(&s.motor_config);
+        sensors_restore_config(&s.sensors_config);
+        observers_restore_config(&s.observers_config);
+        controller_restore_config(&s.controller_config);
+        CAN_restore_config(&s.can_config);
+        traj_planner_restore_config(&s.traj_planner_config);
+        return true;
     }
     return false;
 }
@@ -175,43 +816,84 @@ bool nvm_load_config(void)
     uint32_t slot_addr = SETTINGS_PAGE_HEX +
         (wl_state.current_slot * NVM_SLOT_BYTES);
 
-    // Read metadata
+    // The slot has been validated by the scan, or written and verified
     const NVMMetadata *metadata = (const NVMMetadata *)slot_addr;
-    if (!nvm_wl_validate_metadata(metadata))
+
+    const uint8_t *payload = (const uint8_t *)(slot_addr + NVM_METADATA_SIZE);
+    if (metadata->metadata_version == NVM_METADATA_VERSION_RAW)
     {
-        return false;
+        return nvm_load_raw_config(payload);
     }
 
-    // Read config (skip metadata header)
-    const struct NVMStruct *stored_config =
-        (const struct NVMStruct *)(slot_addr + NVM_METADATA_SIZE);
-    memcpy(&s, stored_config, sizeof(struct NVMStruct));
-
-    // Validate config checksum
-    uint32_t calculated_checksum = calculate_checksum(
-        (const uint8_t *)&s,
-        sizeof(struct NVMStruct) - sizeof(s.checksum)
-    );
-    if (calculated_checksum != s.checksum)
+    // Sections missing from the payload, or with an incompatible
+    // version, keep the firmware defaults
+    nvm_collect_config();
+    memset(wl_state.section_crc, 0, sizeof(wl_state.section_crc));
+    uint32_t loaded = nvm_deserialize_sections(payload, metadata->data_size);
+    if (loaded == 0)
     {
         return false;
     }
 
-    // Validate version
-    if (strncmp(s.version, GIT_VERSION, sizeof(s.version)) == 0)
+    // Apply the records appended since, in order. A record that fails
+    // its checksum leaves the sections it holds as previously saved.
+    uint16_t pos = NVM_ALIGN_ROW(NVM_METADATA_SIZE + metadata->data_size);
+    while (pos < wl_state.log_end)
+    {
+        const NVMRecordHeader *header = (const NVMRecordHeader *)(slot_addr + pos);
+        if (!nvm_record_header_valid(header, pos))
+        {
+            break;
+        }
+        const uint8_t *record = (const uint8_t *)header + sizeof(NVMRecordHeader);
+        if (nvm_sections_valid(NVM_METADATA_VERSION_CRC, record, header->data_size))
+        {
+            loaded |= nvm_deserialize_sections(record, header->data_size);
+        }
+        pos += NVM_ALIGN_ROW(sizeof(NVMRecordHeader) + header->data_size);
+    }
+    wl_state.sections_known = true;
+    if (loaded & NVM_SECTION_BIT(NVM_TAG_FRAMES))
     {
-        // Restore config (existing logic)
         frames_restore_config(&s.frames_config);
+    }
+    if (loaded & NVM_SECTION_BIT(NVM_TAG_ADC))
+    {
         ADC_restore_config(&s.adc_config);
+    }
+    if (loaded & NVM_SECTION_BIT(NVM_TAG_MOTOR))
+    {
         motor_restore_config(&s.motor_config);
+    }
+    if (loaded & NVM_SECTION_BIT(NVM_TAG_SENSORS))
+    {
         sensors_restore_config(&s.sensors_config);
+    }
+    else
+    {
+        sensors_init_with_defaults();
+    }
+    if (loaded & NVM_SECTION_BIT(NVM_TAG_OBSERVERS))
+    {
         observers_restore_config(&s.observers_config);
+    }
+    else
+    {
+        observers_init_with_defaults();
+    }
+    if (loaded & NVM_SECTION_BIT(NVM_TAG_CONTROLLER))
+    {
         controller_restore_config(&s.controller_config);
+    }
+    if (loaded & NVM_SECTION_BIT(NVM_TAG_CAN))
+    {
         CAN_restore_config(&s.can_config);
+    }
+    if (loaded & NVM_SECTION_BIT(NVM_TAG_TRAJ_PLANNER))
+    {
         traj_planner_restore_config(&s.traj_planner_config);
-        return true;
     }
-    return false;
+    return true;
 }
 
 void nvm_erase(void)
@@ -226,7 +908,13 @@ void nvm_erase(void)
     wl_state.current_slot = 0;
     wl_state.latest_sequence = 0;
     wl_state.next_write_slot = 0;
+    wl_state.erased_slots = (1u << NVM_NUM_SLOTS) - 1u;
+    wl_state.log_end = NVM_SLOT_BYTES;
+    wl_state.sections_known = false;
     wl_state.initialized = true;
+    save_state.state = NVM_SAVE_STATE_IDLE;
+    save_state.restart = false;
+    save_state.preerase = false;
 }
 
 // This separate function is needed to interface with the protocol
@@ -257,7 +945,8 @@ bool nvm_wl_validate_metadata(const NVMMetadata *metadata)
     }
 
     // Check metadata version
-    if (metadata->metadata_version != NVM_METADATA_VERSION)
+    if (metadata->metadata_version < NVM_METADATA_VERSION_RAW
+        || metadata->metadata_version > NVM_METADATA_VERSION)
     {
         return false;
     }
@@ -270,7 +959,8 @@ bool nvm_wl_validate_metadata(const NVMMetadata *metadata)
     }
 
     // Verify metadata checksum
-    uint32_t calc_checksum = calculate_checksum(
+    uint32_t calc_checksum = nvm_checksum(
+        metadata->metadata_version,
         (const uint8_t *)metadata,
         sizeof(NVMMetadata) - sizeof(metadata->metadata_checksum)
     );
@@ -282,23 +972,50 @@ bool nvm_wl_validate_metadata(const NVMMetadata *metadata)
     return true;
 }
 
+/**
+ * @brief Validate the payload following valid metadata
+ * @param metadata Pointer to the validated metadata of a slot
+ * @return true if the payload checksum matches, false otherwise
+ */
+bool nvm_wl_validate_payload(const NVMMetadata *metadata)
+{
+    const uint8_t *payload = (const uint8_t *)metadata + NVM_METADATA_SIZE;
+    uint32_t stored_checksum;
+    uint16_t body_size;
+
+    if (metadata->metadata_version == NVM_METADATA_VERSION_RAW)
+    {
+        if (metadata->data_size != sizeof(struct NVMStruct))
+        {
+            return false;
+        }
+        body_size = sizeof(struct NVMStruct) - sizeof(s.checksum);
+        memcpy(&stored_checksum, payload + offsetof(struct NVMStruct, checksum), sizeof(stored_checksum));
+    }
+    else
+    {
+        return nvm_sections_valid(metadata->metadata_version, payload, metadata->data_size);
+    }
+    return nvm_checksum(metadata->metadata_version, payload, body_size) == stored_checksum;
+}
+
 /**
  * @brief Prepare metadata header before write
  * @param metadata Pointer to metadata to fill
- * @param data_size Size of NVMStruct that follows
+ * @param data_size Size of the payload that follows
  */
 void nvm_wl_prepare_metadata(NVMMetadata *metadata, uint16_t data_size)
 {
     metadata->node_id_1 = CAN_get_ID();
     metadata->node_id_2 = CAN_get_ID();
     memset(metadata->reserved, 0, sizeof(metadata->reserved));
-    metadata->sequence_number = wl_state.latest_sequence + 1;
+    metadata->sequence_number = nvm_next_sequence();
     metadata->magic_marker = NVM_MAGIC_MARKER;
     metadata->data_size = data_size;
     metadata->metadata_version = NVM_METADATA_VERSION;
 
     // Calculate metadata checksum (excluding the checksum field itself)
-    metadata->metadata_checksum = calculate_checksum(
+    metadata->metadata_checksum = calculate_crc32(
         (const uint8_t *)metadata,
         sizeof(NVMMetadata) - sizeof(metadata->metadata_checksum)
     );
@@ -307,8 +1024,11 @@ void nvm_wl_prepare_metadata(NVMMetadata *metadata, uint16_t data_size)
 /**
  * @brief Scan all slots to find most recent valid config
  *
- * This function scans all NVM_NUM_SLOTS slots to find the one with the
- * highest sequence number. It handles sequence number wraparound correctly.
+ * Slots carrying the magic marker are indexed by sequence number, which
+ * only requires reading a few words of each. Candidates are then fully
+ * validated newest first, so that normally only the newest slot is
+ * checksummed, and a corrupt slot falls back to the one before it.
+ * Sequence number wraparound is handled by distance-based comparison.
  */
 void nvm_wl_scan_slots(void)
 {
@@ -316,54 +1036,82 @@ void nvm_wl_scan_slots(void)
     wl_state.current_slot = 0;
     wl_state.latest_sequence = 0;
     wl_state.next_write_slot = 0;
+    wl_state.erased_slots = 0;
+    wl_state.log_end = NVM_SLOT_BYTES;
+    wl_state.sections_known = false;
     wl_state.initialized = false;
 
-    bool found_valid_slot = false;
+    // Candidate slots, newest first
+    uint8_t index[NVM_NUM_SLOTS];
+    uint32_t sequence[NVM_NUM_SLOTS];
+    uint8_t count = 0;
 
-    // Scan all slots
     for (uint8_t slot = 0; slot < NVM_NUM_SLOTS; slot++)
     {
-        uint32_t slot_addr = SETTINGS_PAGE_HEX + (slot * NVM_SLOT_BYTES);
-        const NVMMetadata *metadata = (const NVMMetadata *)slot_addr;
-
-        // Check if slot is valid
-        if (nvm_wl_validate_metadata(metadata))
+        const NVMMetadata *metadata = (const NVMMetadata *)(SETTINGS_PAGE_HEX + (slot * NVM_SLOT_BYTES));
+        if (metadata->magic_marker != NVM_MAGIC_MARKER)
         {
-            // Handle sequence number wraparound using distance-based comparison
-            // If the difference is more than UINT32_MAX/2, assume wraparound occurred
-            if (!found_valid_slot)
-            {
-                // First valid slot found
-                wl_state.latest_sequence = metadata->sequence_number;
-                wl_state.current_slot = slot;
-                found_valid_slot = true;
-            }
-            else
-            {
-                // Compare with current latest, handling wraparound
-                uint32_t diff = metadata->sequence_number - wl_state.latest_sequence;
-
-                // If diff is small (< UINT32_MAX/2), it's newer
-                // If diff is large (> UINT32_MAX/2), wraparound occurred and it's older
-                if (diff < (UINT32_MAX / 2))
-                {
-                    wl_state.latest_sequence = metadata->sequence_number;
-                    wl_state.current_slot = slot;
-                }
-            }
+            continue;
+        }
+        // Insert in order. If the difference is more than UINT32_MAX/2,
+        // wraparound occurred and the larger number is older.
+        const uint32_t seq = metadata->sequence_number;
+        uint8_t i = count;
+        while (i > 0 && (seq - sequence[i - 1]) != 0 && (seq - sequence[i - 1]) < (UINT32_MAX / 2))
+        {
+            index[i] = index[i - 1];
+            sequence[i] = sequence[i - 1];
+            i--;
         }
+        index[i] = slot;
+        sequence[i] = seq;
+        count++;
     }
 
-    // Next write goes to slot after current, or slot 0 if no valid config found
-    if (found_valid_slot)
+    for (uint8_t i = 0; i < count; i++)
     {
-        wl_state.next_write_slot = (wl_state.current_slot + 1) % NVM_NUM_SLOTS;
+        const NVMMetadata *metadata = (const NVMMetadata *)(SETTINGS_PAGE_HEX + (index[i] * NVM_SLOT_BYTES));
+        if (nvm_wl_validate_metadata(metadata) && nvm_wl_validate_payload(metadata))
+        {
+            wl_state.current_slot = index[i];
+            wl_state.latest_sequence = sequence[i];
+            // Next full write goes to slot after current
+            wl_state.next_write_slot = (index[i] + 1) % NVM_NUM_SLOTS;
+            nvm_wl_scan_records(metadata);
+            break;
+        }
     }
-    else
+    wl_state.initialized = true;
+}
+
+/**
+ * @brief Find the records appended to the current slot
+ *
+ * Only record headers are read, to find the end of the log and the
+ * latest sequence number; records are validated when loaded. A header
+ * that is neither valid nor blank ends the log, and marks the slot as
+ * full, since the rows following it may have been written.
+ */
+void nvm_wl_scan_records(const NVMMetadata *metadata)
+{
+    const uint8_t *slot_addr = (const uint8_t *)metadata;
+    uint16_t pos = NVM_ALIGN_ROW(NVM_METADATA_SIZE + metadata->data_size);
+    while (pos + sizeof(NVMRecordHeader) <= NVM_SLOT_BYTES)
     {
-        wl_state.next_write_slot = 0;  // Start from slot 0 if no valid config found
+        const NVMRecordHeader *header = (const NVMRecordHeader *)(slot_addr + pos);
+        if (nvm_is_blank(wl_state.current_slot, pos, sizeof(NVMRecordHeader)))
+        {
+            break;
+        }
+        if (!nvm_record_header_valid(header, pos))
+        {
+            pos = NVM_SLOT_BYTES;
+            break;
+        }
+        wl_state.latest_sequence = header->sequence_number;
+        pos += NVM_ALIGN_ROW(sizeof(NVMRecordHeader) + header->data_size);
     }
-    wl_state.initialized = true;
+    wl_state.log_end = pos;
 }
 
 /**
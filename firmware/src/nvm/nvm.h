@@ -32,7 +32,7 @@ typedef struct {
     uint8_t reserved[14];       // Padding for 16-byte alignment
     uint32_t sequence_number;   // Increments with each write, identifies most recent
     uint32_t magic_marker;      // 0x544D4E56 ("TMNV" in ASCII) - validates slot
-    uint16_t data_size;         // Size of NVMStruct (for compatibility check)
+    uint16_t data_size;         // Size of the payload following the metadata
     uint16_t metadata_version;  // Metadata format version (for future changes)
     uint32_t metadata_checksum; // Checksum of this metadata (corruption detection)
 } NVMMetadata;
@@ -55,13 +55,55 @@ struct NVMStruct {
     uint32_t checksum;
 };
 
+// Config sections are stored as tagged records, so that each one can be
+// loaded on its own after a firmware update. Tags must never be reused.
+typedef enum {
+    NVM_TAG_END = 0,
+    NVM_TAG_VERSION = 1,
+    NVM_TAG_FRAMES = 2,
+    NVM_TAG_ADC = 3,
+    NVM_TAG_MOTOR = 4,
+    NVM_TAG_SENSORS = 5,
+    NVM_TAG_OBSERVERS = 6,
+    NVM_TAG_CONTROLLER = 7,
+    NVM_TAG_CAN = 8,
+    NVM_TAG_TRAJ_PLANNER = 9,
+    NVM_TAG_MAX
+} nvm_section_tag;
+
+// Precedes the data of each section. Data is padded to 4 bytes.
+typedef struct {
+    uint8_t tag;
+    uint8_t version;
+    uint16_t length;            // Data length, excluding header and padding
+} NVMSectionHeader;
+
+_Static_assert(sizeof(NVMSectionHeader) == 4, "NVMSectionHeader must be 4 bytes");
+
+// Records appended to a slot after its full config, holding only the
+// sections changed since. The header is followed by tagged sections, an
+// end marker and a checksum, like the slot payload.
+typedef struct {
+    uint32_t sequence_number;   // Continues the sequence of slots
+    uint32_t magic_marker;      // 0x544D4E52 ("TMNR" in ASCII)
+    uint16_t data_size;         // Size of the sections following the header
+    uint16_t reserved;
+    uint32_t checksum;          // CRC-32 of this header
+} NVMRecordHeader;
+
+_Static_assert(sizeof(NVMRecordHeader) == 16, "NVMRecordHeader must fill a flash row");
+
+// Sections, end marker and trailing checksum
+#define NVM_PAYLOAD_MAX_SIZE (sizeof(struct NVMStruct) \
+    + NVM_TAG_MAX * (sizeof(NVMSectionHeader) + 3) + sizeof(uint32_t))
+
 // NVM flash region configuration - PLATFORM DEPENDENT
 #define SETTINGS_PAGE (120)                     // First NVM page (legacy name)
 #define SETTINGS_PAGE_START (120)               // First NVM page
 #define SETTINGS_PAGE_END (127)                 // Last NVM page
 #define SETTINGS_PAGE_HEX (0x0001E000)
 #define NVM_PAGE_SIZE (1024)
-#define SETTINGS_PAGE_COUNT (DIVIDE_AND_ROUND_UP(sizeof(struct NVMStruct), NVM_PAGE_SIZE))
+#define SETTINGS_PAGE_COUNT (DIVIDE_AND_ROUND_UP(NVM_PAYLOAD_MAX_SIZE, NVM_PAGE_SIZE))
 
 // Wear leveling configuration - GENERIC, adapts to any structure size
 #define NVM_TOTAL_PAGES (SETTINGS_PAGE_END - SETTINGS_PAGE_START + 1)  // 8 pages
@@ -70,15 +112,27 @@ struct NVMStruct {
 #define NVM_SLOT_BYTES (NVM_SLOT_SIZE * NVM_PAGE_SIZE)                 // Bytes per slot
 #define NVM_NUM_SLOTS (NVM_TOTAL_PAGES / NVM_SLOT_SIZE)                // Number of slots
 
+// Background saving. Rows are the unit of flash writes.
+#define NVM_ROW_SIZE (16)
+#define NVM_CONTROL_CYCLE_CYCLES (HCLK_FREQ_HZ / PWM_FREQ_HZ)          // Processor cycles per control cycle
+#define NVM_ROW_WRITE_CYCLES_INIT (HCLK_FREQ_HZ / 50000)       // 20us, refined by measurement
+#define NVM_ROW_MARGIN_CYCLES (HCLK_FREQ_HZ / 200000)          // 5us
+#define NVM_PREPARE_CHUNK_SIZE (64)                              // Bytes checksummed per preparation step
+#define NVM_PREPARE_CYCLES_INIT (HCLK_FREQ_HZ / 100000)         // 10us, refined by measurement
+
 // Magic values
 #define NVM_MAGIC_MARKER (0x544D4E56)           // "TMNV" in ASCII
-#define NVM_METADATA_VERSION (1)                 // Current metadata format version
+#define NVM_RECORD_MARKER (0x544D4E52)          // "TMNR" in ASCII
+#define NVM_METADATA_VERSION (3)                 // Current metadata format version
+#define NVM_METADATA_VERSION_CRC (3)             // Tagged sections, CRC-32 checksums
+#define NVM_METADATA_VERSION_SECTIONS (2)        // Tagged sections, byte sum checksums
+#define NVM_METADATA_VERSION_RAW (1)             // Raw NVMStruct, loadable by the same firmware only
 
 // Compile-time validation
 _Static_assert(NVM_TOTAL_PAGES >= 2, "Need at least 2 pages for wear leveling");
 _Static_assert(NVM_NUM_SLOTS >= 2, "Need at least 2 slots for wear leveling");
-_Static_assert(sizeof(struct NVMStruct) + NVM_METADATA_SIZE <= NVM_SLOT_BYTES,
-               "NVMStruct + metadata must fit in slot");
+_Static_assert(NVM_PAYLOAD_MAX_SIZE + NVM_METADATA_SIZE <= NVM_SLOT_BYTES,
+               "Config sections + metadata must fit in slot");
 _Static_assert(NVM_SLOT_SIZE * NVM_NUM_SLOTS == NVM_TOTAL_PAGES,
                "Slots must evenly divide total pages");
 
@@ -86,14 +140,21 @@ extern const uint32_t config_size;
 
 // Main NVM functions
 bool nvm_save_config(void);
+void nvm_save_update(uint32_t cycles_elapsed);
+bool nvm_save_pending(void);
+nvm_save_state_options nvm_get_save_state(void);
+uint8_t nvm_get_save_progress(void);
 bool nvm_load_config(void);
 void nvm_erase(void);
 void nvm_erase_and_reset(void);
 uint32_t calculate_checksum(const uint8_t *data, size_t len);
+uint32_t calculate_crc32(const uint8_t *data, size_t len);
 
 // Wear leveling functions
 void nvm_wl_scan_slots(void);
 bool nvm_wl_validate_metadata(const NVMMetadata *metadata);
+bool nvm_wl_validate_payload(const NVMMetadata *metadata);
+void nvm_wl_scan_records(const NVMMetadata *metadata);
 void nvm_wl_prepare_metadata(NVMMetadata *metadata, uint16_t data_size);
 bool nvm_wl_detect_legacy_config(void);
 bool nvm_wl_migrate_legacy_config(void);
@@ -23,7 +23,7 @@
 
 bool observer_init_with_defaults(Observer *o, Sensor **s)
 {
-	ObserverConfig c = {.track_bw=350};
+	ObserverConfig c = {.track_bw=350, .max_accel=OBSERVER_DEFAULT_MAX_ACCEL};
     return observer_init_with_config(o, s, &c);
 }
 
@@ -41,13 +41,18 @@ void observer_update_params(Observer *o)
 	o->config.ki = 0.25f * (o->config.kp * o->config.kp);
 	o->config.kp_period = o->config.kp * PWM_PERIOD_S;
 	o->config.ki_period = o->config.ki * PWM_PERIOD_S;
+	// Steady state tracking lag at maximum acceleration is a / ki
+	o->config.gate_ticks = OBSERVER_GATE_MIN_TICKS + (o->config.max_accel / o->config.ki);
 }
 
 void observer_reset_state(Observer *o)
 {
-	o->pos_sector = 0;
-	o->pos_estimate_wrapped = 0;
+	o->pos_estimate.turns = 0;
+	o->pos_estimate.ticks = 0;
 	o->vel_estimate = 0;
+	o->rejected = 0;
+	o->coast_cycles = 0;
+	o->lock_cycles = 0;
 	o->current = false;
 }
 
@@ -65,6 +70,20 @@ void observer_set_bandwidth(Observer *o, float bw)
     }
 }
 
+float observer_get_max_accel(Observer *o)
+{
+    return o->config.max_accel;
+}
+
+void observer_set_max_accel(Observer *o, float max_accel)
+{
+    if (max_accel > 0.0f)
+    {
+        o->config.max_accel = max_accel;
+		observer_update_params(o);
+    }
+}
+
 void observers_init_with_defaults(void)
 {
     observer_init_with_defaults(&commutation_observer, &commutation_sensor_p);
@@ -93,4 +112,13 @@ void commutation_observer_set_bandwidth(float bw)
 void position_observer_set_bandwidth(float bw)
 {
 	observer_set_bandwidth(&position_observer, bw);
-}
\ No newline at end of file
+}
+void commutation_observer_set_max_accel(float max_accel)
+{
+	observer_set_max_accel(&commutation_observer, max_accel);
+}
+
+void position_observer_set_max_accel(float max_accel)
+{
+	observer_set_max_accel(&position_observer, max_accel);
+}
@@ -32,14 +32,18 @@ typedef struct
 	float ki;
 	float kp_period;
 	float ki_period;
+	float max_accel;
+	float gate_ticks;
 } ObserverConfig;
 
 struct Observer {
 	ObserverConfig config;
 	Sensor **sensor_ptr;
-	int32_t pos_sector;
-	float pos_estimate_wrapped;
+	TurnPosition pos_estimate;
 	float vel_estimate;
+	uint32_t rejected;
+	uint16_t coast_cycles;
+	uint16_t lock_cycles;
 	bool initialized : 1;
 	bool current : 1;
 };
@@ -59,18 +63,56 @@ void observer_reset_state(Observer *o);
 
 float observer_get_bandwidth(Observer *o);
 void observer_set_bandwidth(Observer *o, float bw);
+float observer_get_max_accel(Observer *o);
+void observer_set_max_accel(Observer *o, float max_accel);
 
 void observers_init_with_defaults(void);
 void observers_get_config(ObserversConfig *config_);
 void observers_restore_config(ObserversConfig *config_);
  
+// Innovation gating. Once the observer tracks the sensor, a sample
+// that deviates from the prediction by more than the sensor noise,
+// the tracking lag at maximum acceleration and the distance that
+// could have been covered while coasting, is taken to be corrupt and
+// the observer coasts on its prediction. Only a sustained deviation
+// is flagged as an error, after which the observer relocks.
+static inline bool observer_accept_sample(Observer *o, float delta_pos_error)
+{
+	if (SENSOR_TYPE_HALL == sensor_get_type(*(o->sensor_ptr)) || o->lock_cycles < OBSERVER_LOCK_CYCLES)
+	{
+		o->lock_cycles++;
+		return true;
+	}
+	float gate = o->config.gate_ticks;
+	if (o->coast_cycles > 0)
+	{
+		const float t = (o->coast_cycles + 1) * PWM_PERIOD_S;
+		gate += 0.5f * o->config.max_accel * t * t;
+	}
+	if (our_fabsf(delta_pos_error) <= gate)
+	{
+		o->coast_cycles = 0;
+		return true;
+	}
+	o->rejected++;
+	o->coast_cycles++;
+	if (o->coast_cycles > OBSERVER_MAX_COAST_CYCLES)
+	{
+		sensor_raise_errors(*(o->sensor_ptr), SENSORS_SETUP_ONBOARD_ERRORS_READING_UNSTABLE);
+		o->coast_cycles = 0;
+		o->lock_cycles = 0;
+		return true;
+	}
+	return false;
+}
+
 static inline void observer_update(Observer *o)
 {
 	if (o->current == false)
 	{
 		const float angle_meas = sensor_get_angle_rectified_normalized(*(o->sensor_ptr));
 		const float delta_pos_est = PWM_PERIOD_S * o->vel_estimate;
-		float delta_pos_meas = angle_meas - o->pos_estimate_wrapped;
+		float delta_pos_meas = angle_meas - o->pos_estimate.ticks;
 		if (delta_pos_meas < -SENSOR_COMMON_RES_HALF_TICKS)
 		{
 			delta_pos_meas += SENSOR_COMMON_RES_TICKS;
@@ -80,19 +122,23 @@ static inline void observer_update(Observer *o)
 			delta_pos_meas -= SENSOR_COMMON_RES_TICKS;
 		}
 		const float delta_pos_error = delta_pos_meas - delta_pos_est;
-		const float incr_pos = delta_pos_est + (o->config.kp_period * delta_pos_error);
-		o->pos_estimate_wrapped += incr_pos;
-		if (o->pos_estimate_wrapped < 0)
+		float incr_pos = delta_pos_est;
+		if (observer_accept_sample(o, delta_pos_error))
 		{
-			o->pos_estimate_wrapped += SENSOR_COMMON_RES_TICKS;
-			o->pos_sector -= 1;
+			incr_pos += o->config.kp_period * delta_pos_error;
+			o->vel_estimate += o->config.ki_period * delta_pos_error;
 		}
-		else if (o->pos_estimate_wrapped >= SENSOR_COMMON_RES_TICKS)
+		o->pos_estimate.ticks += incr_pos;
+		if (o->pos_estimate.ticks < 0)
 		{
-			o->pos_estimate_wrapped -= SENSOR_COMMON_RES_TICKS;
-			o->pos_sector += 1;
+			o->pos_estimate.ticks += SENSOR_COMMON_RES_TICKS;
+			o->pos_estimate.turns -= 1;
+		}
+		else if (o->pos_estimate.ticks >= SENSOR_COMMON_RES_TICKS)
+		{
+			o->pos_estimate.ticks -= SENSOR_COMMON_RES_TICKS;
+			o->pos_estimate.turns += 1;
 		}
-		o->vel_estimate += o->config.ki_period * delta_pos_error;
 		o->current = true;
 	}
 }
@@ -120,15 +166,17 @@ static inline void observer_invalidate(Observer *o)
 
 static inline float observer_get_pos_estimate(Observer *o)
 {
-	const float primary = SENSOR_COMMON_RES_TICKS * o->pos_sector;
-	return primary + o->pos_estimate_wrapped;
+	return turn_position_to_ticks(&(o->pos_estimate));
+}
+
+static inline const TurnPosition *observer_get_turn_position(Observer *o)
+{
+	return &(o->pos_estimate);
 }
 
-static inline float get_diff_position_sensor_frame(float target)
+static inline float get_diff_position_sensor_frame(const TurnPosition *target)
 {
-	const float primary = SENSOR_COMMON_RES_TICKS * position_observer.pos_sector;
-	const float diff_sector = target - primary;
-	return diff_sector - position_observer.pos_estimate_wrapped;
+	return turn_position_diff(target, &(position_observer.pos_estimate));
 }
 
 static inline float observer_get_vel_estimate(Observer *o)
@@ -136,6 +184,11 @@ static inline float observer_get_vel_estimate(Observer *o)
 	return o->vel_estimate;
 }
 
+static inline uint32_t observer_get_rejected(Observer *o)
+{
+	return o->rejected;
+}
+
 // Interface functions
 
 static inline float commutation_observer_get_bandwidth(void)
@@ -145,6 +198,18 @@ static inline float commutation_observer_get_bandwidth(void)
 
 void commutation_observer_set_bandwidth(float bw);
 
+static inline float commutation_observer_get_max_accel(void)
+{
+	return observer_get_max_accel(&commutation_observer);
+}
+
+void commutation_observer_set_max_accel(float max_accel);
+
+static inline uint32_t commutation_observer_get_rejected(void)
+{
+	return observer_get_rejected(&commutation_observer);
+}
+
 static inline float position_observer_get_bandwidth(void)
 {
 	return observer_get_bandwidth(&position_observer);
@@ -152,6 +217,18 @@ static inline float position_observer_get_bandwidth(void)
 
 void position_observer_set_bandwidth(float bw);
 
+static inline float position_observer_get_max_accel(void)
+{
+	return observer_get_max_accel(&position_observer);
+}
+
+void position_observer_set_max_accel(float max_accel);
+
+static inline uint32_t position_observer_get_rejected(void)
+{
+	return observer_get_rejected(&position_observer);
+}
+
 static inline float commutation_observer_get_pos_estimate(void)
 {
 	return observer_get_pos_estimate(&commutation_observer);
@@ -177,6 +254,18 @@ static inline float user_frame_get_pos_estimate(void)
 	return apply_transform(position_observer_get_pos_estimate(), frame_position_sensor_to_user_p());
 }
 
+// Full precision user frame position, split into whole position sensor
+// turns and the remainder expressed in the user frame
+static inline int32_t user_frame_get_pos_turns(void)
+{
+	return position_observer.pos_estimate.turns;
+}
+
+static inline float user_frame_get_pos_in_turn(void)
+{
+	return apply_transform(position_observer.pos_estimate.ticks, frame_position_sensor_to_user_p());
+}
+
 static inline float user_frame_get_vel_estimate(void)
 {
 	return apply_velocity_transform(position_observer_get_vel_estimate(), frame_position_sensor_to_user_p());
@@ -192,13 +281,22 @@ static inline float motor_frame_get_vel_estimate(void)
 	return apply_velocity_transform(commutation_observer_get_vel_estimate(), frame_commutation_sensor_to_motor_p());
 }
 
+// The commutation sensor to motor transform only sets direction (its
+// multiplier is +-1), so whole sensor turns map to whole electrical
+// turns and can be left out. This keeps the electrical angle exact
+// regardless of the distance travelled.
+static inline float motor_frame_get_pos_in_turn(void)
+{
+	return apply_transform(commutation_observer.pos_estimate.ticks, frame_commutation_sensor_to_motor_p());
+}
+
 static inline float observer_get_epos_motor_frame(void)
 {
 	if (SENSOR_TYPE_HALL == ((*(commutation_observer.sensor_ptr))->config.type))
 	{
-		return motor_frame_get_pos_estimate() * twopi_by_common_ticks;
+		return motor_frame_get_pos_in_turn() * twopi_by_common_ticks;
 	}
-	return motor_frame_get_pos_estimate() * twopi_by_common_ticks * motor_get_pole_pairs();
+	return motor_frame_get_pos_in_turn() * twopi_by_common_ticks * motor_get_pole_pairs();
 }
 
 static inline float observer_get_evel_motor_frame(void)
@@ -208,4 +306,11 @@ static inline float observer_get_evel_motor_frame(void)
 		return motor_frame_get_vel_estimate() * twopi_by_common_ticks;
 	}
 	return motor_frame_get_vel_estimate() * twopi_by_common_ticks * motor_get_pole_pairs();
-}
\ No newline at end of file
+}
+// Electrical angle extrapolated to `delay` seconds after the start of
+// the control cycle, accounting for the age of the sensor reading.
+static inline float observer_get_epos_motor_frame_ahead(float delay)
+{
+	const float latency = sensor_get_latency(*(commutation_observer.sensor_ptr)) + delay;
+	return observer_get_epos_motor_frame() + (observer_get_evel_motor_frame() * latency);
+}
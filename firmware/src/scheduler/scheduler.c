@@ -24,42 +24,180 @@
 #include <src/uart/uart_lowlevel.h>
 #include <src/sensor/sensor.h>
 #include <src/sensor/ma7xx.h>
+#include <src/sensor/amt22.h>
 #include <src/observer/observer.h>
 #include <src/can/can_endpoints.h>
 #include <src/scheduler/scheduler.h>
 #include <src/watchdog/watchdog.h>
+#include <src/nvm/nvm.h>
 
 volatile uint32_t msTicks = 0;
 
 volatile SchedulerState scheduler_state = {0};
 
-void wait_for_control_loop_interrupt(void)
+typedef struct
 {
-	while (!scheduler_state.adc_interrupt)
+	bool (*ready)(void);
+	void (*run)(void);
+	uint32_t period;   // Control cycles between runs, 0 for event tasks
+	uint32_t budget;   // Processor cycles a run may take
+} SchedulerTask;
+
+typedef struct
+{
+	uint32_t last_cycle;
+	uint32_t deferred_cycle;
+	bool deferred;
+} SchedulerTaskTiming;
+
+// Frames are only processed while a response can be queued, so that
+// no response is dropped
+static bool can_task_ready(void)
+{
+	return CAN_rx_pending() && CAN_tx_queue_has_room(CAN_TX_PRIORITY_RESPONSE);
+}
+
+// Received frames are processed in bulk, for as long as another one
+// fits in the time left in the cycle
+static void can_task_run(void)
+{
+	do
+	{
+		CAN_process_frame();
+	}
+	while (can_task_ready() && (DWT->CYCCNT + SCHEDULER_CAN_BUDGET_CYCLES <= SCHEDULER_CYCLE_CYCLES));
+}
+
+static bool uart_task_ready(void)
+{
+	return scheduler_state.uart_message_interrupt;
+}
+
+static void uart_task_run(void)
+{
+	scheduler_state.uart_message_interrupt = false;
+	UART_process_message();
+}
+
+static bool wwdt_task_ready(void)
+{
+	return scheduler_state.wwdt_interrupt;
+}
+
+static void wwdt_task_run(void)
+{
+	scheduler_state.wwdt_interrupt = false;
+	WWDT_process_interrupt();
+}
+
+static void nvm_task_run(void)
+{
+	nvm_save_update(DWT->CYCCNT);
+}
+
+static const SchedulerTask scheduler_tasks[SCHEDULER_TASK_COUNT] = {
+	[SCHEDULER_TASK_CAN] = {can_task_ready, can_task_run, 0, SCHEDULER_CAN_BUDGET_CYCLES},
+	[SCHEDULER_TASK_UART] = {uart_task_ready, uart_task_run, 0, SCHEDULER_UART_BUDGET_CYCLES},
+	[SCHEDULER_TASK_WWDT] = {wwdt_task_ready, wwdt_task_run, 0, SCHEDULER_WWDT_BUDGET_CYCLES},
+	// A background config save advances by at most one step per cycle.
+	// It checks the time left itself, as steps vary in length.
+	[SCHEDULER_TASK_NVM] = {nvm_save_pending, nvm_task_run, 1, 0},
+};
+
+static SchedulerTaskTiming scheduler_task_timing[SCHEDULER_TASK_COUNT] = {0};
+
+// Runs the highest priority task that is due and fits in the time left
+// until the next control cycle. A task that does not fit is deferred,
+// and goes ahead of all others once a later cycle has started, so that
+// higher priority tasks cannot starve it. Returns false if no task ran.
+static inline bool run_next_task(void)
+{
+	const uint32_t cycle = scheduler_state.cycle;
+	for (uint8_t pass = 0; pass < 2; pass++)
 	{
-		
-		if (scheduler_state.can_interrupt)
+		for (uint8_t i = 0; i < SCHEDULER_TASK_COUNT; i++)
 		{
-			// Handle CAN
-			CAN_process_interrupt();
-			// Only clear the flag if all messages in the CAN RX buffer have been processed
-			if (PAC55XX_CAN->SR.RBS == 0)
+			const SchedulerTask *task = &scheduler_tasks[i];
+			SchedulerTaskTiming *timing = &scheduler_task_timing[i];
+			if ((pass == 0 && !(timing->deferred && timing->deferred_cycle != cycle))
+				|| (task->period > 0 && cycle - timing->last_cycle < task->period)
+				|| !task->ready())
 			{
-				scheduler_state.can_interrupt = false;
+				continue;
 			}
+			const uint32_t start = DWT->CYCCNT;
+			if (start + task->budget > SCHEDULER_CYCLE_CYCLES)
+			{
+				if (!timing->deferred || timing->deferred_cycle != cycle)
+				{
+					timing->deferred = true;
+					timing->deferred_cycle = cycle;
+					scheduler_state.tasks[i].deferrals++;
+				}
+				continue;
+			}
+			task->run();
+			timing->deferred = false;
+			timing->last_cycle = cycle;
+			scheduler_state.tasks[i].runs++;
+			scheduler_state.tasks[i].cycles += DWT->CYCCNT - start;
+			return true;
 		}
-		else if (scheduler_state.uart_message_interrupt)
+	}
+	return false;
+}
+
+static inline void start_sensor_transfers(void)
+{
+	sensor_invalidate(commutation_sensor_p);
+	sensor_invalidate(position_sensor_p);
+	// If both pointers point to the same sensor, it will only be prepared and updated once
+	sensor_prepare(commutation_sensor_p);
+	sensor_prepare(position_sensor_p);
+	scheduler_state.sensors_pending = true;
+}
+
+// Sheds the next level of optional work when a window of control cycles
+// has too many overruns, and restores a level after enough windows
+// without any
+static inline void update_degradation(void)
+{
+	scheduler_state.window_cycles++;
+	if (scheduler_state.window_cycles < OVERRUN_WINDOW_CYCLES)
+	{
+		return;
+	}
+	const uint32_t overruns = scheduler_state.overruns - scheduler_state.window_overruns;
+	scheduler_state.window_cycles = 0;
+	scheduler_state.window_overruns = scheduler_state.overruns;
+	if (overruns > OVERRUN_SHED_LIMIT)
+	{
+		scheduler_state.restore_windows = 0;
+		if (scheduler_state.degradation < SCHEDULER_DEGRADATION__MAX - 1)
 		{
-			// Handle UART
-			scheduler_state.uart_message_interrupt = false;
-			UART_process_message();
+			scheduler_state.degradation++;
 		}
-		else if (scheduler_state.wwdt_interrupt)
+	}
+	else if (overruns == 0 && scheduler_state.degradation > SCHEDULER_DEGRADATION_NONE)
+	{
+		scheduler_state.restore_windows++;
+		if (scheduler_state.restore_windows >= OVERRUN_RESTORE_WINDOWS)
 		{
-			scheduler_state.wwdt_interrupt = false;
-			WWDT_process_interrupt();
+			scheduler_state.restore_windows = 0;
+			scheduler_state.degradation--;
 		}
-		else
+	}
+	else
+	{
+		scheduler_state.restore_windows = 0;
+	}
+}
+
+void wait_for_control_loop_interrupt(void)
+{
+	while (!scheduler_state.adc_interrupt)
+	{
+		if (!run_next_task())
 		{
 			scheduler_state.busy = false;
 			scheduler_state.load = DWT->CYCCNT;
@@ -71,41 +209,73 @@ void wait_for_control_loop_interrupt(void)
 	}
 	scheduler_state.busy = true;
 	scheduler_state.adc_interrupt = false;
+	const uint32_t start_latency = DWT->CYCCNT - scheduler_state.latency.irq_cycles;
 	DWT->CYCCNT = 0;
+	scheduler_state.cycle++;
+	scheduler_state.latency.start = start_latency;
+	scheduler_histogram_add(&scheduler_state.latency.start_histogram, start_latency, SCHEDULER_START_BIN_CYCLES);
+	update_degradation();
 	// We have to service the control loop by updating
 	// current measurements and encoder estimates.
-	sensor_invalidate(commutation_sensor_p);
-	sensor_invalidate(position_sensor_p);
+	// Sensor transfers are normally started by the ADC interrupt, and
+	// only need to be started here if it found the previous readings
+	// still being collected.
+	if (!scheduler_state.sensors_pending && !scheduler_state.sensors_suspended)
+	{
+		start_sensor_transfers();
+	}
 	observer_invalidate(&commutation_observer);
 	observer_invalidate(&position_observer);
-	// If both pointers point to the same sensor, it will only br prepared and updated once
-	sensor_prepare(commutation_sensor_p);
-	sensor_prepare(position_sensor_p);
 	ADC_update();
+	const uint32_t collect_start = DWT->CYCCNT;
 	sensor_update(commutation_sensor_p, true);
 	sensor_update(position_sensor_p, true);
+	scheduler_state.sensor_wait = DWT->CYCCNT - collect_start;
+	scheduler_state.sensors_pending = false;
 	observer_update(&commutation_observer);
 	observer_update(&position_observer);
 	// At this point control is returned to main loop.
 }
 
+void scheduler_reset_latency(void)
+{
+	scheduler_state.latency.start_histogram = (SchedulerHistogram){0};
+	scheduler_state.latency.duty_histogram = (SchedulerHistogram){0};
+}
+
 void ADC_IRQHandler(void)
 {
+	scheduler_state.latency.irq_cycles = DWT->CYCCNT;
 	PAC55XX_ADC->ADCINT.ADCIRQ0IF = 1;
 	scheduler_state.adc_interrupt = true;
+	// Start sensor transfers right at the PWM trigger, so that they
+	// run while the control loop wakes up and samples currents
+	if (!scheduler_state.sensors_pending && !scheduler_state.sensors_suspended)
+	{
+		start_sensor_transfers();
+	}
 	// Only in case the gate driver is enabled, raise a
 	// warning if the control loop is about to be
 	// reentered
 	if (gate_driver_is_enabled() && scheduler_state.busy)
 	{
 		scheduler_state.warnings |= SCHEDULER_WARNINGS_CONTROL_BLOCK_REENTERED;
+		scheduler_state.overruns++;
 	}
 }
 
+void TimerB_IRQHandler(void)
+{
+	PAC55XX_TIMERB->INT.BASEIF = 1;
+	amt22_sequence_step();
+}
+
 void CAN_IRQHandler(void)
 {
+	pac5xxx_can_int_clear_TI();
+	CAN_process_tx_interrupt();
 	pac5xxx_can_int_clear_RI();
-	scheduler_state.can_interrupt = true;
+	CAN_process_rx_interrupt();
 }
 
 void SysTick_Handler(void)
@@ -17,14 +17,81 @@
 
 #pragma once
 
+#include <src/common.h>
+#include <src/tm_enums.h>
+
+// Processor cycles per control cycle, the time background tasks share
+#define SCHEDULER_CYCLE_CYCLES (HCLK_FREQ_HZ / PWM_FREQ_HZ)
+
+// Worst case time of a background task run, in processor cycles
+#define SCHEDULER_CAN_BUDGET_CYCLES (HCLK_FREQ_HZ / 100000)    // 10us per frame
+#define SCHEDULER_UART_BUDGET_CYCLES (HCLK_FREQ_HZ / 100000)   // 10us
+#define SCHEDULER_WWDT_BUDGET_CYCLES (HCLK_FREQ_HZ / 1000000)  // 1us
+
+// Worst case time of the control loop, after which the remainder of the
+// control cycle is left to background tasks
+#define SCHEDULER_CONTROL_CYCLES (5000)
+
+// A task must fit in an idle period by itself, or it could be deferred forever
+_Static_assert(SCHEDULER_CAN_BUDGET_CYCLES < SCHEDULER_CYCLE_CYCLES - SCHEDULER_CONTROL_CYCLES, "CAN task budget exceeds the idle time");
+_Static_assert(SCHEDULER_UART_BUDGET_CYCLES < SCHEDULER_CYCLE_CYCLES - SCHEDULER_CONTROL_CYCLES, "UART task budget exceeds the idle time");
+_Static_assert(SCHEDULER_WWDT_BUDGET_CYCLES < SCHEDULER_CYCLE_CYCLES - SCHEDULER_CONTROL_CYCLES, "WWDT task budget exceeds the idle time");
+
+// Background tasks, in order of priority
+typedef enum
+{
+	SCHEDULER_TASK_CAN = 0,
+	SCHEDULER_TASK_UART,
+	SCHEDULER_TASK_WWDT,
+	SCHEDULER_TASK_NVM,
+	SCHEDULER_TASK_COUNT
+} SchedulerTaskId;
+
+typedef struct
+{
+	uint32_t runs;
+	uint32_t cycles;
+	uint32_t deferrals;
+} SchedulerTaskStats;
+
+// Latency histograms. The last bin also counts all longer latencies.
+#define SCHEDULER_LATENCY_BINS (8)
+#define SCHEDULER_START_BIN_CYCLES (64)
+#define SCHEDULER_DUTY_BIN_CYCLES (1024)
+_Static_assert(SCHEDULER_LATENCY_BINS * SCHEDULER_DUTY_BIN_CYCLES >= SCHEDULER_CYCLE_CYCLES, "Duty latency bins must cover a control cycle");
+
+typedef struct
+{
+	uint32_t bins[SCHEDULER_LATENCY_BINS];
+	uint32_t max;
+} SchedulerHistogram;
+
+typedef struct
+{
+	uint32_t irq_cycles;  // DWT->CYCCNT at the last ADC interrupt
+	uint32_t start;       // Latency of the current cycle start
+	SchedulerHistogram start_histogram;
+	SchedulerHistogram duty_histogram;
+} SchedulerLatency;
+
 typedef struct 
 {
 	bool adc_interrupt;
-	bool can_interrupt;
 	bool uart_message_interrupt;
     bool wwdt_interrupt;
 	bool busy;
+	bool sensors_pending;
+	bool sensors_suspended;
 	uint32_t load;
+	uint32_t sensor_wait;
+	uint32_t cycle;
+	SchedulerTaskStats tasks[SCHEDULER_TASK_COUNT];
+	SchedulerLatency latency;
+	uint32_t overruns;
+	uint32_t window_overruns;  // Overrun count at the start of the window
+	uint16_t window_cycles;
+	uint16_t restore_windows;
+	scheduler_degradation_options degradation;
 
     uint8_t warnings;
 } SchedulerState;
@@ -32,6 +99,30 @@ typedef struct
 extern volatile SchedulerState scheduler_state;
 
 void wait_for_control_loop_interrupt(void);
+void scheduler_reset_latency(void);
+
+static inline void scheduler_histogram_add(volatile SchedulerHistogram *histogram, uint32_t latency, uint32_t bin_cycles)
+{
+	uint32_t bin = latency / bin_cycles;
+	if (bin >= SCHEDULER_LATENCY_BINS)
+	{
+		bin = SCHEDULER_LATENCY_BINS - 1;
+	}
+	histogram->bins[bin]++;
+	if (latency > histogram->max)
+	{
+		histogram->max = latency;
+	}
+}
+
+// Records the latency from the ADC interrupt to the duty cycle write of
+// the closed loop controller. Duty cycles written outside of the control
+// loop, e.g. by calibration or state changes, are not recorded.
+static inline void scheduler_record_duty_latency(void)
+{
+	scheduler_histogram_add(&scheduler_state.latency.duty_histogram,
+		scheduler_state.latency.start + DWT->CYCCNT, SCHEDULER_DUTY_BIN_CYCLES);
+}
 
 static inline uint8_t scheduler_get_warnings(void)
 {
@@ -41,4 +132,100 @@ static inline uint8_t scheduler_get_warnings(void)
 static inline uint32_t scheduler_get_load(void)
 {
 	return scheduler_state.load;
-}
\ No newline at end of file
+}
+
+static inline uint32_t scheduler_get_overruns(void)
+{
+	return scheduler_state.overruns;
+}
+
+static inline scheduler_degradation_options scheduler_get_degradation(void)
+{
+	return scheduler_state.degradation;
+}
+
+// Whether the optional work of the given level is currently shed
+static inline bool scheduler_sheds(scheduler_degradation_options level)
+{
+	return scheduler_state.degradation >= level;
+}
+
+// Used while a routine accesses a sensor bus directly, outside of the
+// control loop. Both functions are called from the main loop context.
+static inline void scheduler_suspend_sensor_transfers(void)
+{
+	scheduler_state.sensors_suspended = true;
+}
+
+static inline void scheduler_resume_sensor_transfers(void)
+{
+	// Any transfer started before suspending has been consumed by
+	// the routine, so the next cycle starts afresh
+	scheduler_state.sensors_pending = false;
+	scheduler_state.sensors_suspended = false;
+}
+
+static inline uint32_t scheduler_get_sensor_wait(void)
+{
+	return scheduler_state.sensor_wait;
+}
+
+static inline uint32_t scheduler_get_task_runs(SchedulerTaskId task)
+{
+	return scheduler_state.tasks[task].runs;
+}
+
+static inline uint32_t scheduler_get_task_cycles(SchedulerTaskId task)
+{
+	return scheduler_state.tasks[task].cycles;
+}
+
+static inline uint32_t scheduler_get_task_deferrals(SchedulerTaskId task)
+{
+	return scheduler_state.tasks[task].deferrals;
+}
+
+static inline uint32_t scheduler_get_latency_bin(const volatile SchedulerHistogram *histogram, uint8_t bin)
+{
+	return histogram->bins[bin];
+}
+
+static inline uint32_t scheduler_get_start_latency_max(void)
+{
+	return scheduler_state.latency.start_histogram.max;
+}
+
+static inline uint32_t scheduler_get_duty_latency_max(void)
+{
+	return scheduler_state.latency.duty_histogram.max;
+}
+
+// Endpoint getters
+#define scheduler_get_can_runs() scheduler_get_task_runs(SCHEDULER_TASK_CAN)
+#define scheduler_get_can_cycles() scheduler_get_task_cycles(SCHEDULER_TASK_CAN)
+#define scheduler_get_can_deferrals() scheduler_get_task_deferrals(SCHEDULER_TASK_CAN)
+#define scheduler_get_uart_runs() scheduler_get_task_runs(SCHEDULER_TASK_UART)
+#define scheduler_get_uart_cycles() scheduler_get_task_cycles(SCHEDULER_TASK_UART)
+#define scheduler_get_uart_deferrals() scheduler_get_task_deferrals(SCHEDULER_TASK_UART)
+#define scheduler_get_wwdt_runs() scheduler_get_task_runs(SCHEDULER_TASK_WWDT)
+#define scheduler_get_wwdt_cycles() scheduler_get_task_cycles(SCHEDULER_TASK_WWDT)
+#define scheduler_get_wwdt_deferrals() scheduler_get_task_deferrals(SCHEDULER_TASK_WWDT)
+#define scheduler_get_nvm_runs() scheduler_get_task_runs(SCHEDULER_TASK_NVM)
+#define scheduler_get_nvm_cycles() scheduler_get_task_cycles(SCHEDULER_TASK_NVM)
+#define scheduler_get_nvm_deferrals() scheduler_get_task_deferrals(SCHEDULER_TASK_NVM)
+#define scheduler_get_start_latency_bin_0() scheduler_get_latency_bin(&scheduler_state.latency.start_histogram, 0)
+#define scheduler_get_start_latency_bin_1() scheduler_get_latency_bin(&scheduler_state.latency.start_histogram, 1)
+#define scheduler_get_start_latency_bin_2() scheduler_get_latency_bin(&scheduler_state.latency.start_histogram, 2)
+#define scheduler_get_start_latency_bin_3() scheduler_get_latency_bin(&scheduler_state.latency.start_histogram, 3)
+#define scheduler_get_start_latency_bin_4() scheduler_get_latency_bin(&scheduler_state.latency.start_histogram, 4)
+#define scheduler_get_start_latency_bin_5() scheduler_get_latency_bin(&scheduler_state.latency.start_histogram, 5)
+#define scheduler_get_start_latency_bin_6() scheduler_get_latency_bin(&scheduler_state.latency.start_histogram, 6)
+#define scheduler_get_start_latency_bin_7() scheduler_get_latency_bin(&scheduler_state.latency.start_histogram, 7)
+#define scheduler_get_duty_latency_bin_0() scheduler_get_latency_bin(&scheduler_state.latency.duty_histogram, 0)
+#define scheduler_get_duty_latency_bin_1() scheduler_get_latency_bin(&scheduler_state.latency.duty_histogram, 1)
+#define scheduler_get_duty_latency_bin_2() scheduler_get_latency_bin(&scheduler_state.latency.duty_histogram, 2)
+#define scheduler_get_duty_latency_bin_3() scheduler_get_latency_bin(&scheduler_state.latency.duty_histogram, 3)
+#define scheduler_get_duty_latency_bin_4() scheduler_get_latency_bin(&scheduler_state.latency.duty_histogram, 4)
+#define scheduler_get_duty_latency_bin_5() scheduler_get_latency_bin(&scheduler_state.latency.duty_histogram, 5)
+#define scheduler_get_duty_latency_bin_6() scheduler_get_latency_bin(&scheduler_state.latency.duty_histogram, 6)
+#define scheduler_get_duty_latency_bin_7() scheduler_get_latency_bin(&scheduler_state.latency.duty_histogram, 7)
@@ -22,6 +22,11 @@
 #include <src/sensor/sensor.h>
 #include <src/sensor/amt22.h>
 
+// The sensor whose read sequence is paced by the sensor timer
+static AMT22Sensor *active_sensor = NULL;
+
+static void amt22_read_blocking(AMT22Sensor *as);
+
 void amt22_make_blank_sensor(Sensor *s)
 {
     AMT22Sensor *as = (AMT22Sensor *)s;
@@ -30,6 +35,7 @@ void amt22_make_blank_sensor(Sensor *s)
     s->bits = AMT22_BITS;
     s->ticks = AMT22_TICKS;
     s->normalization_factor = SENSOR_COMMON_RES_TICKS_FLOAT / s->ticks;
+    s->latency = AMT22_LATENCY_S;
     s->get_raw_angle_func = amt22_get_raw_angle;
     s->update_func = amt22_update; 
     s->prepare_func = amt22_send_angle_cmd; 
@@ -39,6 +45,7 @@ void amt22_make_blank_sensor(Sensor *s)
     s->get_errors_func = amt22_get_errors; 
     s->is_calibrated_func = amt22_is_calibrated; 
     s->get_ss_config_func = amt22_get_ss_config;
+    s->read_checked_func = amt22_read_checked;
 }
 
 bool amt22_init_with_port_and_rate(Sensor *s, const SSP_TYPE port, PAC55XX_SSP_TYPEDEF *ssp_struct, sensors_setup_external_spi_rate_options rate)
@@ -60,11 +67,18 @@ bool amt22_init_with_config(Sensor *s, const AMT22SensorConfig *c)
 bool amt22_init(Sensor *s)
 {
     AMT22Sensor *as = (AMT22Sensor *)s;
-    ssp_init(as->config.ssp_port, SSP_MS_MASTER, 16, SSP_DATA_SIZE_8, SWSEL_SW, 0, 0);
+    sensor_timer_stop();
+    as->seq = AMT22_SEQ_IDLE;
+    // Time to clock out one byte (SSPCLK = PCLK / (3 * N)) plus the idle gap
+    const uint8_t clk_div = sensor_spi_rate_clk_div[as->config.rate];
+    as->step_ticks = (uint16_t)(((uint64_t)(8 * 3 * clk_div) * TIMER_FREQ_HZ) / HCLK_FREQ_HZ) + AMT22_GAP_TICKS;
+    ssp_init(as->config.ssp_port, SSP_MS_MASTER, clk_div, SSP_DATA_SIZE_8, SWSEL_SW, 0, 0);
     delay_us(50000); 
     
-    amt22_send_angle_cmd(s); 
+    // Interrupts may not be enabled yet, so read once synchronously
+    amt22_read_blocking(as);
     amt22_update(s, false); 
+    active_sensor = as;
 
     s->initialized = true;
     return true;
@@ -72,7 +86,14 @@ bool amt22_init(Sensor *s)
 
 void amt22_deinit(Sensor *s)
 {
-    ssp_deinit(((AMT22Sensor *)s)->config.ssp_port);
+    AMT22Sensor *as = (AMT22Sensor *)s;
+    if (active_sensor == as)
+    {
+        sensor_timer_stop();
+        active_sensor = NULL;
+    }
+    as->seq = AMT22_SEQ_IDLE;
+    ssp_deinit(as->config.ssp_port);
     s->initialized = false;
 }
 
@@ -86,3 +107,82 @@ void amt22_get_ss_config(Sensor *s, void* buffer)
     const AMT22Sensor *ss = ((const AMT22Sensor *)s);
     memcpy(buffer, &(ss->config), sizeof(ss->config));
 }
+
+// AMT22 needs idle time between selecting the chip, the two bytes of
+// the angle and deselecting. Instead of busy waiting, the read is
+// sequenced by the sensor timer interrupt and runs in the background
+// of the control loop.
+TM_RAMFUNC void amt22_send_angle_cmd(const Sensor *s)
+{
+    AMT22Sensor *as = (AMT22Sensor *)s;
+    if (as->seq == AMT22_SEQ_IDLE && active_sensor == as)
+    {
+        as->config.ssp_struct->SSCR.SWSS = 0;
+        as->seq = AMT22_SEQ_SELECT;
+        sensor_timer_start(AMT22_GAP_TICKS);
+    }
+}
+
+TM_RAMFUNC void amt22_sequence_step(void)
+{
+    AMT22Sensor *as = active_sensor;
+    if (as == NULL)
+    {
+        return;
+    }
+    PAC55XX_SSP_TYPEDEF *ssp = as->config.ssp_struct;
+    switch (as->seq)
+    {
+        case AMT22_SEQ_SELECT:
+            ssp_write_one(ssp, AMT22_CMD_READ_ANGLE);
+            as->seq = AMT22_SEQ_HIGH_BYTE;
+            sensor_timer_start(as->step_ticks);
+            break;
+        case AMT22_SEQ_HIGH_BYTE:
+            as->pending = (ssp_read_one(ssp) & 0xff) << 8;
+            ssp_write_one(ssp, AMT22_CMD_READ_ANGLE);
+            as->seq = AMT22_SEQ_LOW_BYTE;
+            sensor_timer_start(as->step_ticks);
+            break;
+        case AMT22_SEQ_LOW_BYTE:
+            // Publish both bytes with a single store
+            as->value = as->pending | (ssp_read_one(ssp) & 0xff);
+            ssp->SSCR.SWSS = 1;
+            as->seq = AMT22_SEQ_IDLE;
+            break;
+        default:
+            break;
+    }
+}
+
+bool amt22_sequence_busy(void)
+{
+    return (active_sensor != NULL) && (active_sensor->seq != AMT22_SEQ_IDLE);
+}
+
+static void amt22_read_blocking(AMT22Sensor *as)
+{
+    PAC55XX_SSP_TYPEDEF *ssp = as->config.ssp_struct;
+    ssp->SSCR.SWSS = 0;
+    delay_us(3);
+    ssp_write_one(ssp, AMT22_CMD_READ_ANGLE);
+    const uint16_t val_h = ssp_read_one(ssp) & 0xff;
+    delay_us(3);
+    ssp_write_one(ssp, AMT22_CMD_READ_ANGLE);
+    const uint16_t val_l = ssp_read_one(ssp) & 0xff;
+    delay_us(3);
+    ssp->SSCR.SWSS = 1;
+    as->value = (val_h << 8) | val_l;
+}
+
+bool amt22_read_checked(Sensor *s)
+{
+    AMT22Sensor *as = (AMT22Sensor *)s;
+    amt22_read_blocking(as);
+    if (amt22_checksum_is_valid(as->value))
+    {
+        as->angle = as->value & 0x3FFF;
+        return true;
+    }
+    return false;
+}
@@ -20,19 +20,27 @@
 #include <src/ssp/ssp_func.h>
 #include <src/can/can_endpoints.h>
 #include <src/sensor/sensor.h>
+#include <src/timer/timer.h>
 
 #define AMT22_BITS (14) // Assuming a 14-bit resolution for consistency
 #define AMT22_TICKS (1 << AMT22_BITS)
-#define AMT22_MAX_ALLOWED_DELTA     (AMT22_TICKS / 6)
-#define AMT22_MAX_ALLOWED_DELTA_ADD (AMT22_MAX_ALLOWED_DELTA + AMT22_TICKS)
-#define AMT22_MAX_ALLOWED_DELTA_SUB (AMT22_MAX_ALLOWED_DELTA - AMT22_TICKS)
-#define AMT22_MIN_ALLOWED_DELTA_ADD (-AMT22_MAX_ALLOWED_DELTA + AMT22_TICKS)
-#define AMT22_MIN_ALLOWED_DELTA_SUB (-AMT22_MAX_ALLOWED_DELTA - AMT22_TICKS)
+// Readings are clocked out in the background and collected in the
+// following control cycle, so they are about one period old.
+#define AMT22_LATENCY_S (PWM_PERIOD_S)
+// Minimum idle time around each byte, 2.5us with some margin
+#define AMT22_GAP_TICKS (3 * SENSOR_TIMER_TICKS_PER_US)
 
 typedef enum {
     AMT22_CMD_READ_ANGLE       = 0xFFFF
 } AMT22Command;
 
+typedef enum {
+    AMT22_SEQ_IDLE = 0,
+    AMT22_SEQ_SELECT = 1,    // Chip selected, waiting to clock the first byte
+    AMT22_SEQ_HIGH_BYTE = 2, // First byte in flight
+    AMT22_SEQ_LOW_BYTE = 3   // Second byte in flight
+} AMT22Sequence;
+
 typedef struct
 {
     SSP_TYPE ssp_port;
@@ -46,9 +54,10 @@ typedef struct
     AMT22SensorConfig config;
     uint8_t errors;
     int32_t angle;
-    uint8_t val_l;
-    uint8_t val_h;
-
+    volatile uint16_t value;
+    uint16_t pending;
+    uint16_t step_ticks;
+    volatile AMT22Sequence seq;
 } AMT22Sensor;
 
 void amt22_make_blank_sensor(Sensor *s);
@@ -58,6 +67,10 @@ bool amt22_init(Sensor *s);
 void amt22_deinit(Sensor *s);
 void amt22_reset(Sensor *s);
 void amt22_get_ss_config(Sensor *s, void* buffer);
+bool amt22_read_checked(Sensor *s);
+void amt22_send_angle_cmd(const Sensor *s);
+void amt22_sequence_step(void);
+bool amt22_sequence_busy(void);
 
 static inline bool amt22_is_calibrated(const Sensor *s)
 {
@@ -69,22 +82,13 @@ static inline uint8_t amt22_get_errors(const Sensor *s)
     return ((const AMT22Sensor *)s)->errors;
 }
 
-static inline void amt22_send_angle_cmd(const Sensor *s)
+// Bits 15 and 14 are odd parity checks over the odd and even
+// bits of the 14-bit angle respectively
+static inline bool amt22_checksum_is_valid(uint16_t value)
 {
-    // AMT22 has specific timing requirements with respect to reading
-    // the first and second bytes of the angle.
-    // TODO: These delays make reading of the sensor really slow
-    // refactor using interrupts
-    AMT22Sensor *as = ((AMT22Sensor *)s);
-    as->config.ssp_struct->SSCR.SWSS = 0;
-    delay_us(3);
-    ssp_write_one(as->config.ssp_struct, AMT22_CMD_READ_ANGLE);
-    as->val_h = ssp_read_one(as->config.ssp_struct);
-    delay_us(3);
-    ssp_write_one(as->config.ssp_struct, AMT22_CMD_READ_ANGLE);
-    as->val_l = ssp_read_one(as->config.ssp_struct);
-    delay_us(3);
-    as->config.ssp_struct->SSCR.SWSS = 1;
+    const bool k1 = (value >> 15) & 1;
+    const bool k0 = (value >> 14) & 1;
+    return (k1 == !__builtin_parity(value & 0x2AAA)) && (k0 == !__builtin_parity(value & 0x1555));
 }
 
 static inline int32_t amt22_get_raw_angle(const Sensor *s)
@@ -96,34 +100,17 @@ static inline void amt22_update(Sensor *s, bool check_error)
 {
     AMT22Sensor *as = (AMT22Sensor *)s;
 
-    const int32_t value = (((as->val_h & 0xff) << 8) | (as->val_l & 0xff)); 
-    
-    // TODO: This checksum calculation is sub-optimal
-    bool binaryArray[16];
-
-    for(int i = 0; i < 16; i++) binaryArray[i] = (0x01) & (value >> (i));
-
-    if ((binaryArray[15] == !(binaryArray[13] ^ binaryArray[11] ^ binaryArray[9] ^ binaryArray[7] ^ binaryArray[5] ^ binaryArray[3] ^ binaryArray[1]))
-          && (binaryArray[14] == !(binaryArray[12] ^ binaryArray[10] ^ binaryArray[8] ^ binaryArray[6] ^ binaryArray[4] ^ binaryArray[2] ^ binaryArray[0])))
+    // Collect the reading completed in the background during the
+    // previous cycle
+    const uint16_t value = as->value;
+    if (!amt22_checksum_is_valid(value))
     {
-        const int32_t angle = value & 0x3FFF; 
-        if (check_error)
-        {
-            const int32_t delta = as->angle - angle;
-            if ( ((delta > AMT22_MAX_ALLOWED_DELTA) || (delta < -AMT22_MAX_ALLOWED_DELTA)) &&
-                ((delta > AMT22_MAX_ALLOWED_DELTA_ADD) || (delta < AMT22_MIN_ALLOWED_DELTA_ADD)) &&
-                ((delta > AMT22_MAX_ALLOWED_DELTA_SUB) || (delta < AMT22_MIN_ALLOWED_DELTA_SUB)) )
-            {
-                
-            }
-            else
-            {
-                as->angle = value & 0x3FFF;
-            }
-        }
-        
+        // Hold the last valid angle
+        return;
     }
-    
+    // Glitches are rejected by the observer
+    (void)check_error;
+    as->angle = value & 0x3FFF;
 }
 
 
@@ -30,6 +30,7 @@ void as5047p_make_blank_sensor(Sensor *s)
     s->bits = AS5047_BITS;
     s->ticks = AS5047_TICKS;
     s->normalization_factor = SENSOR_COMMON_RES_TICKS_FLOAT / s->ticks;
+    s->latency = AS5047_LATENCY_S;
     s->get_raw_angle_func = as5047p_get_raw_angle;
     s->update_func = as5047p_update; 
     s->prepare_func = as5047p_send_angle_cmd; 
@@ -39,6 +40,7 @@ void as5047p_make_blank_sensor(Sensor *s)
     s->get_errors_func = as5047p_get_errors; 
     s->is_calibrated_func = as5047p_is_calibrated; 
     s->get_ss_config_func = as5047p_get_ss_config;
+    s->read_checked_func = as5047p_read_checked;
 }
 
 bool as5047p_init_with_port_and_rate(Sensor *s, const SSP_TYPE port, PAC55XX_SSP_TYPEDEF *ssp_struct, sensors_setup_external_spi_rate_options rate)
@@ -60,7 +62,7 @@ bool as5047p_init_with_config(Sensor *s, const AS5047PSensorConfig *c)
 bool as5047p_init(Sensor *s)
 {
     AS5047PSensor *as = (AS5047PSensor *)s;
-    ssp_init(as->config.ssp_port, SSP_MS_MASTER, 16, SSP_DATA_SIZE_16, SWSEL_SPI, 1, 0);
+    ssp_init(as->config.ssp_port, SSP_MS_MASTER, sensor_spi_rate_clk_div[as->config.rate], SSP_DATA_SIZE_16, SWSEL_SPI, 1, 0);
     delay_us(10000); // Example delay, adjust based on AS5047P datasheet
 
     as5047p_send_angle_cmd(s); 
@@ -84,4 +86,16 @@ void as5047p_get_ss_config(Sensor *s, void* buffer)
 {
     const AS5047PSensor *ss = ((const AS5047PSensor *)s);
     memcpy(buffer, &(ss->config), sizeof(ss->config));
-}
\ No newline at end of file
+}
+bool as5047p_read_checked(Sensor *s)
+{
+    AS5047PSensor *as = (AS5047PSensor *)s;
+    as5047p_send_angle_cmd(s);
+    const uint16_t frame = ssp_read_one(as->config.ssp_struct);
+    if (as5047p_frame_is_valid(frame))
+    {
+        as->angle = frame & 0x3FFF;
+        return true;
+    }
+    return false;
+}
@@ -23,15 +23,13 @@
 
 #define AS5047_BITS (14) // The bits we READ, not the advertised resolution
 #define AS5047_TICKS (1 << AS5047_BITS)
-#define AS5047_MAX_ALLOWED_DELTA     (AS5047_TICKS / 6)
-#define AS5047_MAX_ALLOWED_DELTA_ADD (AS5047_MAX_ALLOWED_DELTA + AS5047_TICKS)
-#define AS5047_MAX_ALLOWED_DELTA_SUB (AS5047_MAX_ALLOWED_DELTA - AS5047_TICKS)
-#define AS5047_MIN_ALLOWED_DELTA_ADD (-AS5047_MAX_ALLOWED_DELTA + AS5047_TICKS)
-#define AS5047_MIN_ALLOWED_DELTA_SUB (-AS5047_MAX_ALLOWED_DELTA - AS5047_TICKS)
+// The propagation delay is compensated internally (DAEC), but the angle
+// read in each cycle answers the command sent in the previous one.
+#define AS5047_LATENCY_S (PWM_PERIOD_S)
 
 typedef enum {
     AS5047P_CMD_NOP              = 0x0000,
-    AS5047P_CMD_READ_ANGLE       = 0x3FFF 
+    AS5047P_CMD_READ_ANGLE       = 0xFFFF // Read ANGLECOM (0x3FFF), with R/W and parity bits set
 } AS5047PCommand;
 
 typedef struct
@@ -56,6 +54,13 @@ bool as5047p_init(Sensor *s);
 void as5047p_deinit(Sensor *s);
 void as5047p_reset(Sensor *s);
 void as5047p_get_ss_config(Sensor *s, void* buffer);
+bool as5047p_read_checked(Sensor *s);
+
+// Responses carry an even parity bit (15) and an error flag (14)
+static inline bool as5047p_frame_is_valid(uint16_t frame)
+{
+    return (__builtin_parity(frame) == 0) && ((frame & 0x4000) == 0);
+}
 
 static inline bool as5047p_is_calibrated(const Sensor *s)
 {
@@ -80,17 +85,14 @@ static inline int32_t as5047p_get_raw_angle(const Sensor *s)
 static inline void as5047p_update(Sensor *s, bool check_error)
 {
     AS5047PSensor *as = (AS5047PSensor *)s;
-    volatile uint16_t read_value = ssp_read_one(as->config.ssp_struct);
-    const int32_t angle = read_value & 0x3FFF; // Mask to get the angle value
-    if (check_error)
+    const uint16_t read_value = ssp_read_one(as->config.ssp_struct);
+    if (!as5047p_frame_is_valid(read_value))
     {
-    	const int32_t delta = as->angle - angle;
-		if ( ((delta > AS5047_MAX_ALLOWED_DELTA) || (delta < -AS5047_MAX_ALLOWED_DELTA)) &&
-		     ((delta > AS5047_MAX_ALLOWED_DELTA_ADD) || (delta < AS5047_MIN_ALLOWED_DELTA_ADD)) &&
-		     ((delta > AS5047_MAX_ALLOWED_DELTA_SUB) || (delta < AS5047_MIN_ALLOWED_DELTA_SUB)) )
-		{
-            as->errors |= SENSORS_SETUP_ONBOARD_ERRORS_READING_UNSTABLE;
-		}
+        // Hold the last valid angle
+        return;
     }
+    const int32_t angle = read_value & 0x3FFF; // Mask to get the angle value
+    // Glitches are rejected by the observer
+    (void)check_error;
     as->angle = angle;
 }
\ No newline at end of file
@@ -30,6 +30,7 @@ void hall_make_blank_sensor(Sensor *s)
     s->bits = HALL_BITS;
     s->ticks = HALL_SECTORS;
     s->normalization_factor = SENSOR_COMMON_RES_TICKS_FLOAT / s->ticks;
+    s->latency = HALL_LATENCY_S;
     s->get_raw_angle_func = hall_get_angle;
     s->update_func = hall_update;
     s->reset_func = hall_reset;
@@ -22,6 +22,8 @@
 #define HALL_BITS (3)
 #define HALL_SECTORS ((1 << HALL_BITS) - 2)
 #define HALL_SECTOR_ANGLE (TWOPI / HALL_SECTORS)
+// Hall inputs are sampled directly in the control interrupt
+#define HALL_LATENCY_S (0.0f)
 #define CAL_DIR_LEN_PER_SECTOR (CAL_DIR_LEN / HALL_SECTORS)
 
 static const float twopi_by_hall_sectors = TWOPI / HALL_SECTORS;
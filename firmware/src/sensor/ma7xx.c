@@ -30,6 +30,7 @@ void ma7xx_make_blank_sensor(Sensor *s)
     s->bits = MA7XX_BITS;
     s->ticks = MA7XX_TICKS;
     s->normalization_factor = SENSOR_COMMON_RES_TICKS_FLOAT / s->ticks;
+    s->latency = MA7XX_LATENCY_S;
     s->is_calibrated_func = ma7xx_rec_is_calibrated;
     s->get_raw_angle_func = ma7xx_get_raw_angle;
     s->init_func = ma7xx_init;
@@ -39,6 +40,7 @@ void ma7xx_make_blank_sensor(Sensor *s)
     s->prepare_func = ma7xx_send_angle_cmd;
     s->get_errors_func = ma7xx_get_errors;
     s->get_ss_config_func = ma7xx_get_ss_config;
+    s->read_checked_func = ma7xx_read_checked;
 }
 
 bool ma7xx_init_with_port_and_rate(Sensor *s, const SSP_TYPE port, PAC55XX_SSP_TYPEDEF *ssp_struct, sensors_setup_external_spi_rate_options rate)
@@ -60,7 +62,7 @@ bool ma7xx_init_with_port_and_rate(Sensor *s, const SSP_TYPE port, PAC55XX_SSP_T
  bool ma7xx_init(Sensor *s)
 {
     MA7xxSensor *ms = (MA7xxSensor *)s;
-    ssp_init(ms->config.ssp_port, SSP_MS_MASTER, 4, SSP_DATA_SIZE_16, SWSEL_SPI, 0, 0);
+    ssp_init(ms->config.ssp_port, SSP_MS_MASTER, sensor_spi_rate_clk_div[ms->config.rate], SSP_DATA_SIZE_16, SWSEL_SPI, 0, 0);
     delay_us(16000); // ensure 16ms sensor startup time as per the datasheet
     ma7xx_send_angle_cmd(s);
     ma7xx_update(s, false);
@@ -84,3 +86,12 @@ void ma7xx_get_ss_config(Sensor *s, void* buffer)
     const MA7xxSensor *ss = ((const MA7xxSensor *)s);
     memcpy(buffer, &(ss->config), sizeof(ss->config));
 }
+
+bool ma7xx_read_checked(Sensor *s)
+{
+    // MagAlpha angle frames carry no check bits, so readings can
+    // only be validated for consistency by the caller
+    ma7xx_send_angle_cmd(s);
+    ma7xx_update(s, false);
+    return true;
+}
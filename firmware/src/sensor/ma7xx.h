@@ -23,11 +23,9 @@
 
 #define MA7XX_BITS (16) // The bits we READ, not the advertised resolution
 #define MA7XX_TICKS (1 << MA7XX_BITS)
-#define MA7XX_MAX_ALLOWED_DELTA     (MA7XX_TICKS / 6)
-#define MA7XX_MAX_ALLOWED_DELTA_ADD (MA7XX_MAX_ALLOWED_DELTA + MA7XX_TICKS)
-#define MA7XX_MAX_ALLOWED_DELTA_SUB (MA7XX_MAX_ALLOWED_DELTA - MA7XX_TICKS)
-#define MA7XX_MIN_ALLOWED_DELTA_ADD (-MA7XX_MAX_ALLOWED_DELTA + MA7XX_TICKS)
-#define MA7XX_MIN_ALLOWED_DELTA_SUB (-MA7XX_MAX_ALLOWED_DELTA - MA7XX_TICKS)
+// The angle is latched when the transfer starts; what remains is the
+// signal path delay of the sensor itself.
+#define MA7XX_LATENCY_S (3.0e-6f)
 
 typedef enum {
     MA_CMD_NOP              = 0x0000,
@@ -58,6 +56,7 @@ bool ma7xx_init(Sensor *s);
 void ma7xx_deinit(Sensor *s);
 void ma7xx_reset(Sensor *s);
 void ma7xx_get_ss_config(Sensor *s, void* buffer);
+bool ma7xx_read_checked(Sensor *s);
 
 static inline bool ma7xx_rec_is_calibrated(const Sensor *s)
 {
@@ -84,16 +83,8 @@ static inline void ma7xx_update(Sensor *s, bool check_error)
     MA7xxSensor *ms = (MA7xxSensor *)s;
     const int32_t angle = ssp_read_one(ms->config.ssp_struct);
 
-    if (check_error)
-    {
-    	const int32_t delta = ms->angle - angle;
-		if ( ((delta > MA7XX_MAX_ALLOWED_DELTA) || (delta < -MA7XX_MAX_ALLOWED_DELTA)) &&
-		     ((delta > MA7XX_MAX_ALLOWED_DELTA_ADD) || (delta < MA7XX_MIN_ALLOWED_DELTA_ADD)) &&
-		     ((delta > MA7XX_MAX_ALLOWED_DELTA_SUB) || (delta < MA7XX_MIN_ALLOWED_DELTA_SUB)) )
-		{
-            ms->errors |= SENSORS_SETUP_ONBOARD_ERRORS_READING_UNSTABLE;
-		}
-    }
+    // Glitches are rejected by the observer
+    (void)check_error;
     ms->angle = angle;
 }
 
@@ -22,10 +22,15 @@
 void sensor_reset(Sensor *s)
 {
     (void)memset(s->config.rec_table, 0, sizeof(s->config.rec_table));
+    s->config.rec_type = SENSORS_SETUP_RECTIFICATION_TABLE;
 	s->config.rec_calibrated = false;
 }
 
-bool sensor_calibrate_eccentricity_compensation(Sensor *s, Observer *o, FrameTransform *xf_motor_to_sensor)
+static void sensor_fit_harmonics(float *h, const float *error_ticks, int16_t n, float e_pos_step_ticks,
+    FrameTransform *xf_motor_to_sensor);
+
+bool sensor_calibrate_eccentricity_compensation(Sensor *s, Observer *o, FrameTransform *xf_motor_to_sensor,
+    sensors_setup_rectification_options rec_type)
 {
     // Size below is an arbitrary large number ie > ECN_SIZE * npp
     float error_ticks[ECN_SIZE * MOTOR_MAX_POLE_PAIRS];
@@ -66,28 +71,72 @@ bool sensor_calibrate_eccentricity_compensation(Sensor *s, Observer *o, FrameTra
     // temporarily disable the inverter, as the following computations will probably exceed a single PWM cycle
     gate_driver_disable();
 
-    // FIR filtering and map measurements to lut
-    for (int16_t i=0; i<ECN_SIZE; i++)
+    if (SENSORS_SETUP_RECTIFICATION_HARMONIC == rec_type)
+    {
+        (void)memset(s->config.rec_table, 0, sizeof(s->config.rec_table));
+        sensor_fit_harmonics(s->config.rec_harmonics, error_ticks, n, delta * nconv * e_pos_to_ticks, xf_motor_to_sensor);
+        s->config.rec_type = SENSORS_SETUP_RECTIFICATION_HARMONIC;
+    }
+    else
     {
-        float acc = 0;
-        for (int16_t j = 0; j < ECN_SIZE; j++)
+        // FIR filtering and map measurements to lut
+        for (int16_t i=0; i<ECN_SIZE; i++)
         {
-            int32_t read_idx = -ECN_SIZE / 2 + j + i * npp;
-            if (read_idx < 0)
+            float acc = 0;
+            for (int16_t j = 0; j < ECN_SIZE; j++)
             {
-                read_idx += n;
+                int32_t read_idx = -ECN_SIZE / 2 + j + i * npp;
+                if (read_idx < 0)
+                {
+                    read_idx += n;
+                }
+                else if (read_idx > n - 1)
+                {
+                    read_idx -= n;
+                }
+                acc += error_ticks[read_idx];
             }
-            else if (read_idx > n - 1)
-            {
-                read_idx -= n;
-            }
-            acc += error_ticks[read_idx];
+            acc = acc / ((float)(ECN_SIZE * 2));
+            lut[i] = (int32_t)acc;
         }
-        acc = acc / ((float)(ECN_SIZE * 2));
-        lut[i] = (int32_t)acc;
     }
     gate_driver_enable();
     wait_pwm_cycles(5000);
     s->config.rec_calibrated = true;
     return true;
 }
+
+// Least squares fit of a Fourier series to the angle error. Each error
+// sample sums a forward and a backward pass, taken one step apart, so
+// samples are centered half a step past the forward reference. As samples
+// are evenly spaced over a sensor turn, the normal equations are diagonal
+// and each coefficient reduces to a projection of the error onto its basis
+// function.
+static void sensor_fit_harmonics(float *h, const float *error_ticks, int16_t n, float e_pos_step_ticks,
+    FrameTransform *xf_motor_to_sensor)
+{
+    for (int16_t i = 0; i < n; i++)
+    {
+        const float ref = apply_transform((i + 0.5f) * e_pos_step_ticks, xf_motor_to_sensor);
+        float s1;
+        float c1;
+        fast_sincos(ref * twopi_by_common_ticks, &s1, &c1);
+        float s_k = s1;
+        float c_k = c1;
+        const float e = error_ticks[i];
+        h[0] += e;
+        for (uint8_t k = 0; k < ECN_HARMONICS; k++)
+        {
+            h[(2 * k) + 1] += e * c_k;
+            h[(2 * k) + 2] += e * s_k;
+            const float c_next = (c_k * c1) - (s_k * s1);
+            s_k = (s_k * c1) + (c_k * s1);
+            c_k = c_next;
+        }
+    }
+    h[0] *= 0.5f / n;
+    for (uint8_t k = 1; k < (2 * ECN_HARMONICS + 1); k++)
+    {
+        h[k] *= 1.0f / n;
+    }
+}
@@ -18,9 +18,12 @@
 #pragma once
 
 #include <src/common.h>
+#include <src/utils/utils.h>
 #include <src/xfs.h>
+#include <src/tm_enums.h>
 #include <src/ssp/ssp_func.h>
 #include <src/motor/motor.h>
+#include <src/scheduler/scheduler.h>
 
 #if defined(BOARD_REV_R53)
 #define ONBOARD_SENSOR_SSP_PORT SSPC
@@ -37,6 +40,9 @@
 #define ONBOARD_SENSOR_SSP_STRUCT PAC55XX_SSPD
 #endif
 
+// SSP clock divider for each rate option, SSPCLK = PCLK / (3 * N)
+static const uint8_t sensor_spi_rate_clk_div[SENSORS_SETUP_EXTERNAL_SPI_RATE__MAX] = {32, 16, 8, 6, 4, 2};
+
 typedef struct Sensor Sensor;
 typedef struct SensorConfig SensorConfig;
 typedef struct Observer Observer;
@@ -51,6 +57,7 @@ typedef void (*sensor_prepare_func_t)(const Sensor *);
 typedef void (*sensor_update_func_t)(Sensor *, bool);
 typedef void (*sensor_get_ss_config_func_t)(Sensor* sensor, void* buffer);
 typedef uint8_t (*sensor_get_errors_func_t)(const Sensor *);
+typedef bool (*sensor_read_checked_func_t)(Sensor *);
 
 typedef enum {
     SENSOR_TYPE_INVALID = 0,
@@ -68,10 +75,16 @@ typedef enum {
     SENSOR_CONNECTION_MAX
 } sensor_connection_t;
 
+_Static_assert((2 * ECN_HARMONICS + 1) <= ECN_SIZE, "Rectification harmonics must fit in the table storage");
+
 struct SensorConfig {
     uint32_t id;
     sensor_type_t type;
-    int32_t rec_table[ECN_SIZE];
+    union {
+        int32_t rec_table[ECN_SIZE];
+        float rec_harmonics[2 * ECN_HARMONICS + 1]; // Mean, then cosine and sine coefficients by harmonic
+    };
+    sensors_setup_rectification_options rec_type;
     bool rec_calibrated;
 };
 
@@ -87,16 +100,19 @@ struct Sensor { // typedefd earlier
     sensor_prepare_func_t prepare_func;
     sensor_get_ss_config_func_t get_ss_config_func;
     sensor_get_errors_func_t get_errors_func;
+    sensor_read_checked_func_t read_checked_func; // Blocking read, returns whether the frame passed integrity checks
     uint8_t bits;
     uint32_t ticks;
     float normalization_factor;
+    float latency; // Age of the reading when the control cycle starts, in seconds
     bool initialized : 1;
     bool prepared : 1;
     bool updated : 1;
 };
 
 void sensor_reset(Sensor *s);
-bool sensor_calibrate_eccentricity_compensation(Sensor *s, Observer *o, FrameTransform *xf_motor_to_sensor);
+bool sensor_calibrate_eccentricity_compensation(Sensor *s, Observer *o, FrameTransform *xf_motor_to_sensor,
+    sensors_setup_rectification_options rec_type);
 
 
 static inline void sensor_update(Sensor *s, bool check_error)
@@ -124,6 +140,11 @@ static inline uint32_t sensor_get_ticks(const Sensor *s)
     return s->ticks;
 }
 
+static inline float sensor_get_latency(const Sensor *s)
+{
+    return s->latency;
+}
+
 static inline sensor_type_t sensor_get_type(const Sensor *s)
 {
     return s->config.type;
@@ -143,12 +164,46 @@ static inline int32_t sensor_get_angle_rectified(const Sensor *s)
     const uint8_t offset_bits = (sensor_get_bits(s) - ECN_BITS);
     const int32_t angle = s->get_raw_angle_func(s);
     const int32_t off_1 = s->config.rec_table[angle>>offset_bits];
+    if (scheduler_sheds(SCHEDULER_DEGRADATION_RECTIFICATION))
+    {
+        // Under overload, the table is read without interpolation
+        return angle + off_1;
+    }
 	const int32_t off_2 = s->config.rec_table[((angle>>offset_bits) + 1) % ECN_SIZE];
 	const int32_t off_interp = off_1 + ((off_2 - off_1)* (angle - ((angle>>offset_bits)<<offset_bits))>>offset_bits);
 	return angle + off_interp;
 }
 
+// Evaluates the Fourier series of the angle error at the given angle in
+// common ticks. Higher harmonics are obtained by successive rotation of
+// the fundamental, so a single sincos evaluation is needed.
+static inline float sensor_get_harmonic_correction(const float *h, float angle, uint8_t harmonics)
+{
+    float s1;
+    float c1;
+    fast_sincos(angle * twopi_by_common_ticks, &s1, &c1);
+    float s_k = s1;
+    float c_k = c1;
+    float correction = h[0];
+    for (uint8_t k = 0; k < harmonics; k++)
+    {
+        correction += (h[(2 * k) + 1] * c_k) + (h[(2 * k) + 2] * s_k);
+        const float c_next = (c_k * c1) - (s_k * s1);
+        s_k = (s_k * c1) + (c_k * s1);
+        c_k = c_next;
+    }
+    return correction;
+}
+
 static inline float sensor_get_angle_rectified_normalized(const Sensor *s)
 {
+    if (SENSORS_SETUP_RECTIFICATION_HARMONIC == s->config.rec_type)
+    {
+        const float angle = s->get_raw_angle_func(s) * s->normalization_factor;
+        // Under overload, only the lower half of the harmonics is evaluated
+        const uint8_t harmonics = scheduler_sheds(SCHEDULER_DEGRADATION_RECTIFICATION) ?
+            (ECN_HARMONICS / 2) : ECN_HARMONICS;
+        return angle + sensor_get_harmonic_correction(s->config.rec_harmonics, angle, harmonics);
+    }
     return sensor_get_angle_rectified(s) * s->normalization_factor;
 }
\ No newline at end of file
@@ -18,9 +18,13 @@
 #include <src/sensor/sensors.h>
 #include <src/observer/observer.h>
 #include <src/controller/controller.h>
+#include <src/scheduler/scheduler.h>
 
 GenSensor sensors[SENSOR_COUNT] = {0};
 
+// Rectification representation used by the next eccentricity calibration
+static sensors_setup_rectification_options rectification = SENSORS_SETUP_RECTIFICATION_TABLE;
+
 void sensor_make_blank(Sensor *s)
 {
     // Here we check the sensor connection, either
@@ -147,12 +151,14 @@ void sensors_get_config(SensorsConfig *config_)
     }
     config_->commutation_connection = sensor_get_connection(commutation_sensor_p);
     config_->position_connection = sensor_get_connection(position_sensor_p);
+    config_->rectification = rectification;
 }
 
 void sensors_restore_config(SensorsConfig *config_)
 {
     sensor_set_pointer_with_connection(&commutation_sensor_p, config_->commutation_connection);
     sensor_set_pointer_with_connection(&position_sensor_p, config_->position_connection);
+    rectification = config_->rectification;
 
     // Restore SensorConfig array
     for (int i = 0; i < SENSOR_COUNT; ++i)
@@ -171,6 +177,37 @@ void sensors_restore_config(SensorsConfig *config_)
     }
 }
 
+sensors_setup_rectification_options sensors_get_rectification(void)
+{
+    return rectification;
+}
+
+void sensors_set_rectification(sensors_setup_rectification_options rec_type)
+{
+    if (rec_type < SENSORS_SETUP_RECTIFICATION__MAX)
+    {
+        rectification = rec_type;
+    }
+}
+
+// Sensor transfers are started by the ADC interrupt, so any routine
+// reconfiguring a sensor or its bus from the main loop context keeps
+// the interrupt off the sensors until done.
+static void sensors_suspend_transfers(void)
+{
+    scheduler_suspend_sensor_transfers();
+    // Let any transfer in flight complete. The AMT22 read is a sequence
+    // of frames paced by the sensor timer, so it is waited for separately.
+    delay_us(SENSOR_FRAME_MAX_US);
+    while (amt22_sequence_busy()) {}
+    if (scheduler_state.sensors_pending)
+    {
+        // Collect the readings, so that none are left in the receive FIFOs
+        sensor_update(commutation_sensor_p, false);
+        sensor_update(position_sensor_p, false);
+    }
+}
+
 void commutation_sensor_set_connection(sensor_connection_t new_connection)
 {
     sensor_set_connection(&(commutation_sensor_p), &(position_sensor_p), new_connection);
@@ -205,56 +242,112 @@ void sensor_external_spi_set_type_avlos(sensors_setup_external_spi_type_options
         frames_reset_calibrated();
         
         Sensor *s = &(sensors[SENSOR_CONNECTION_EXTERNAL_SPI].sensor);
+        sensors_suspend_transfers();
         if (s->initialized)
         {
             s->deinit_func(s);
         }
         sensors[SENSOR_CONNECTION_EXTERNAL_SPI].sensor.config.type = internal_type;
         sensor_init_with_defaults(s);
+        scheduler_resume_sensor_transfers();
     }
 }
 
+static void sensor_external_spi_apply_rate(sensors_setup_external_spi_rate_options rate)
+{
+    Sensor *s = &(sensors[SENSOR_CONNECTION_EXTERNAL_SPI].sensor);
+    s->deinit_func(s);
+    switch (s->config.type)
+    {
+        case SENSOR_TYPE_MA7XX:
+            sensors[SENSOR_CONNECTION_EXTERNAL_SPI].ma7xx_sensor.config.rate = rate;
+            break;
+        case SENSOR_TYPE_AS5047:
+            sensors[SENSOR_CONNECTION_EXTERNAL_SPI].as5047p_sensor.config.rate = rate;
+            break;
+        case SENSOR_TYPE_AMT22:
+            sensors[SENSOR_CONNECTION_EXTERNAL_SPI].amt22_sensor.config.rate = rate;
+            break;
+        default:
+            break;
+    }
+    s->init_func(s);
+}
+
 void sensor_external_spi_set_rate_avlos(sensors_setup_external_spi_rate_options rate)
 {
     if (rate < SENSORS_SETUP_EXTERNAL_SPI_RATE__MAX
-        && (controller_get_state() == CONTROLLER_STATE_IDLE))
+        && (controller_get_state() == CONTROLLER_STATE_IDLE)
+        && rate != sensor_external_spi_get_rate_avlos())
+    {
+        sensors_suspend_transfers();
+        sensor_external_spi_apply_rate(rate);
+        scheduler_resume_sensor_transfers();
+    }
+}
+
+// Reads the sensor repeatedly at the current rate. The motor is idle,
+// so consecutive readings a few microseconds apart should agree; this
+// catches corrupted bits in sensors without check bits.
+static bool sensor_external_spi_probe(Sensor *s)
+{
+    const int32_t half_ticks = (int32_t)(s->ticks >> 1);
+    const int32_t max_delta = (int32_t)(s->ticks / SPI_RATE_PROBE_MAX_DELTA_DIV);
+    int32_t last_angle = 0;
+    for (uint32_t i = 0; i < SPI_RATE_PROBE_SAMPLES; i++)
     {
-        sensors_setup_external_spi_rate_options current_rate;
-        switch (sensors[SENSOR_CONNECTION_EXTERNAL_SPI].sensor.config.type)
+        if (!s->read_checked_func(s))
         {
-            case SENSOR_TYPE_MA7XX:
-                current_rate = sensors[SENSOR_CONNECTION_EXTERNAL_SPI].ma7xx_sensor.config.rate;
-                break;
-            case SENSOR_TYPE_AS5047:
-                current_rate = sensors[SENSOR_CONNECTION_EXTERNAL_SPI].as5047p_sensor.config.rate;
-                break;
-            case SENSOR_TYPE_AMT22:
-                current_rate = sensors[SENSOR_CONNECTION_EXTERNAL_SPI].amt22_sensor.config.rate;
-                break;
-            default:
-                current_rate = sensors[SENSOR_CONNECTION_EXTERNAL_SPI].ma7xx_sensor.config.rate;
-                break;
+            return false;
         }
-        if (rate != current_rate)
+        const int32_t angle = s->get_raw_angle_func(s);
+        if (i > 0)
         {
-            sensors[SENSOR_CONNECTION_EXTERNAL_SPI].sensor.deinit_func(&(sensors[SENSOR_CONNECTION_EXTERNAL_SPI].sensor));
-            switch (sensors[SENSOR_CONNECTION_EXTERNAL_SPI].sensor.config.type)
+            int32_t delta = angle - last_angle;
+            if (delta > half_ticks)
             {
-                case SENSOR_TYPE_MA7XX:
-                    sensors[SENSOR_CONNECTION_EXTERNAL_SPI].ma7xx_sensor.config.rate = rate;
-                    break;
-                case SENSOR_TYPE_AS5047:
-                    sensors[SENSOR_CONNECTION_EXTERNAL_SPI].as5047p_sensor.config.rate = rate;
-                    break;
-                case SENSOR_TYPE_AMT22:
-                    current_rate = sensors[SENSOR_CONNECTION_EXTERNAL_SPI].amt22_sensor.config.rate = rate;
-                    break;
-                default:
-                    break;
+                delta -= (int32_t)s->ticks;
             }
-            sensors[SENSOR_CONNECTION_EXTERNAL_SPI].sensor.init_func(&(sensors[SENSOR_CONNECTION_EXTERNAL_SPI].sensor));
+            else if (delta < -half_ticks)
+            {
+                delta += (int32_t)s->ticks;
+            }
+            if (delta > max_delta || delta < -max_delta)
+            {
+                return false;
+            }
+        }
+        last_angle = angle;
+        delay_us(SPI_RATE_PROBE_INTERVAL_US);
+    }
+    return true;
+}
+
+bool sensor_external_spi_autodetect_rate(void)
+{
+    Sensor *s = &(sensors[SENSOR_CONNECTION_EXTERNAL_SPI].sensor);
+    if (controller_get_state() != CONTROLLER_STATE_IDLE
+        || s->initialized == false || s->read_checked_func == NULL)
+    {
+        return false;
+    }
+    sensors_suspend_transfers();
+    const sensors_setup_external_spi_rate_options initial_rate = sensor_external_spi_get_rate_avlos();
+    int32_t best_rate = -1;
+    for (int32_t rate = 0; rate < SENSORS_SETUP_EXTERNAL_SPI_RATE__MAX; rate++)
+    {
+        sensor_external_spi_apply_rate((sensors_setup_external_spi_rate_options)rate);
+        if (!sensor_external_spi_probe(s))
+        {
+            // Faster rates are not expected to fare better
+            break;
         }
+        best_rate = rate;
     }
+    sensor_external_spi_apply_rate(best_rate >= 0 ?
+        (sensors_setup_external_spi_rate_options)best_rate : initial_rate);
+    scheduler_resume_sensor_transfers();
+    return best_rate >= 0;
 }
 
 void sensor_set_connection(Sensor** target_sensor_p, Sensor** other_sensor_p, sensor_connection_t new_connection)
@@ -264,6 +357,7 @@ void sensor_set_connection(Sensor** target_sensor_p, Sensor** other_sensor_p, se
         && new_connection >= 0 && new_connection < SENSOR_CONNECTION_MAX)
     {
         frames_reset_calibrated();
+        sensors_suspend_transfers();
 
         if (sensor_get_connection(*target_sensor_p) != sensor_get_connection(*other_sensor_p))
         {
@@ -278,6 +372,7 @@ void sensor_set_connection(Sensor** target_sensor_p, Sensor** other_sensor_p, se
             observer_reset_state(observer_get_for_sensor(*target_sensor_p));
             sensor_init_with_defaults(*target_sensor_p);
         }
+        scheduler_resume_sensor_transfers();
     }
 }
 
@@ -26,6 +26,12 @@
 
 #define SENSOR_COUNT 3
 
+#define SPI_RATE_PROBE_SAMPLES (64)
+#define SPI_RATE_PROBE_INTERVAL_US (50)
+#define SPI_RATE_PROBE_MAX_DELTA_DIV (64) // Max change between samples, as a fraction of a turn
+// Longest single SPI frame: 16 bits at the slowest rate, SSPCLK = PCLK / (3 * 32)
+#define SENSOR_FRAME_MAX_US ((16 * 3 * 32) / (HCLK_FREQ_HZ / 1000000) + 1)
+
 typedef struct Observer Observer;
 
 extern Observer commutation_observer;
@@ -54,6 +60,7 @@ typedef struct
     GenSensorConfig ss_config[SENSOR_COUNT];
     sensor_connection_t commutation_connection;
     sensor_connection_t position_connection;
+    sensors_setup_rectification_options rectification;
 } SensorsConfig;
 
 // The sequence in the `sensors` array is determined so that
@@ -90,6 +97,11 @@ static inline sensor_connection_t commutation_sensor_get_connection(void)
 
 void commutation_sensor_set_connection(sensor_connection_t new_connection);
 
+static inline float commutation_sensor_get_latency(void)
+{
+    return sensor_get_latency(commutation_sensor_p);
+}
+
 static inline sensor_connection_t position_sensor_get_connection(void)
 {
     return sensor_get_connection(position_sensor_p);
@@ -97,6 +109,8 @@ static inline sensor_connection_t position_sensor_get_connection(void)
 
 void position_sensor_set_connection(sensor_connection_t new_connection);
 bool sensors_calibrate_pole_pair_count_and_transforms(void);
+sensors_setup_rectification_options sensors_get_rectification(void);
+void sensors_set_rectification(sensors_setup_rectification_options rec_type);
 
 static inline void sensors_reset(void)
 {
@@ -107,27 +121,37 @@ static inline void sensors_reset(void)
     }
 }
 
-static inline void sensors_calibrate(void)
+static inline bool sensors_calibrate(void)
 {
-    if (position_sensor_p->calibrate_func)
+    if (position_sensor_p->calibrate_func
+        && !position_sensor_p->calibrate_func(position_sensor_p, &position_observer))
     {
-        position_sensor_p->calibrate_func(position_sensor_p, &position_observer);
+        return false;
     }
-    if ((commutation_sensor_p != position_sensor_p) && (commutation_sensor_p->calibrate_func))
+    if ((commutation_sensor_p != position_sensor_p) && (commutation_sensor_p->calibrate_func)
+        && !commutation_sensor_p->calibrate_func(commutation_sensor_p, &commutation_observer))
     {
-        commutation_sensor_p->calibrate_func(commutation_sensor_p, &commutation_observer);
+        return false;
     }
 
-    sensors_calibrate_pole_pair_count_and_transforms();
+    if (!sensors_calibrate_pole_pair_count_and_transforms())
+    {
+        return false;
+    }
 
-    if (sensor_get_type(commutation_sensor_p) != SENSOR_TYPE_HALL)
+    if (sensor_get_type(commutation_sensor_p) != SENSOR_TYPE_HALL
+        && !sensor_calibrate_eccentricity_compensation(commutation_sensor_p, &commutation_observer, frame_motor_to_commutation_sensor_p(),
+            sensors_get_rectification()))
     {
-        sensor_calibrate_eccentricity_compensation(commutation_sensor_p, &commutation_observer, frame_motor_to_commutation_sensor_p());
+        return false;
     }
-    if (commutation_sensor_p != position_sensor_p && sensor_get_type(position_sensor_p) != SENSOR_TYPE_HALL)
+    if (commutation_sensor_p != position_sensor_p && sensor_get_type(position_sensor_p) != SENSOR_TYPE_HALL
+        && !sensor_calibrate_eccentricity_compensation(position_sensor_p, &position_observer, frame_motor_to_position_sensor_p(),
+            sensors_get_rectification()))
     {
-        sensor_calibrate_eccentricity_compensation(position_sensor_p, &position_observer, frame_motor_to_position_sensor_p());
+        return false;
     }
+    return true;
 }
 
 static inline sensors_setup_external_spi_type_options sensor_external_spi_get_type_avlos(void)
@@ -170,6 +194,7 @@ static inline sensors_setup_external_spi_rate_options sensor_external_spi_get_ra
 
 void sensor_external_spi_set_type_avlos(sensors_setup_external_spi_type_options type);
 void sensor_external_spi_set_rate_avlos(sensors_setup_external_spi_rate_options rate);
+bool sensor_external_spi_autodetect_rate(void);
 
 static inline bool sensor_onboard_get_is_calibrated(void)
 {
@@ -186,6 +211,28 @@ static inline bool sensor_hall_get_is_calibrated(void)
     return sensors[SENSOR_CONNECTION_HALL].sensor.is_calibrated_func(&(sensors[SENSOR_CONNECTION_HALL].sensor));
 }
 
+static inline void sensor_raise_errors(Sensor *s, uint8_t errors)
+{
+    GenSensor *gs = (GenSensor *)s;
+    switch (s->config.type)
+    {
+        case SENSOR_TYPE_MA7XX:
+            gs->ma7xx_sensor.errors |= errors;
+            break;
+        case SENSOR_TYPE_AS5047:
+            gs->as5047p_sensor.errors |= errors;
+            break;
+        case SENSOR_TYPE_AMT22:
+            gs->amt22_sensor.errors |= errors;
+            break;
+        case SENSOR_TYPE_HALL:
+            gs->hall_sensor.errors |= errors;
+            break;
+        default:
+            break;
+    }
+}
+
 static inline uint8_t sensor_onboard_get_errors(void)
 {
     return sensors[SENSOR_CONNECTION_ONBOARD_SPI].sensor.get_errors_func(&(sensors[SENSOR_CONNECTION_ONBOARD_SPI].sensor));
@@ -824,6 +824,7 @@ void ssp_init(SSP_TYPE ssp, SSP_MS_TYPE ms_mode, uint8_t clkn_div, uint32_t data
 //    ssp_ptr->IMSC.RTIM = 1;                                  // Enable RX Timeout interrupt
 
     ssp_ptr->CON.SSPEN = SSP_CONTROL_ENABLE;                 // SSP Enable
+    ssp_flush_rx(ssp_ptr);                                   // Discard data left from a previous configuration
 }
 
 void ssp_deinit(SSP_TYPE ssp)
@@ -940,6 +941,14 @@ TM_RAMFUNC uint32_t ssp_write_multi(PAC55XX_SSP_TYPEDEF *ssp_ptr, uint16_t *data
     return result;
 }
 
+TM_RAMFUNC void ssp_flush_rx(PAC55XX_SSP_TYPEDEF *ssp_ptr)
+{
+    while (ssp_ptr->STAT.RNE)
+    {
+        (void)ssp_ptr->DAT.DATA;
+    }
+}
+
 TM_RAMFUNC uint16_t ssp_read_one(PAC55XX_SSP_TYPEDEF *ssp_ptr)
 {
     // Might be worth adding a timeout
@@ -51,5 +51,6 @@ extern void ssp_deinit(SSP_TYPE ssp);
 extern uint32_t ssp_write_one(PAC55XX_SSP_TYPEDEF *ssp_ptr, uint16_t data);
 extern uint32_t ssp_write_multi(PAC55XX_SSP_TYPEDEF *ssp_ptr, uint16_t *data, uint32_t byte_num);
 extern uint16_t ssp_read_one(PAC55XX_SSP_TYPEDEF *ssp_ptr);
+extern void ssp_flush_rx(PAC55XX_SSP_TYPEDEF *ssp_ptr);
 
 #endif
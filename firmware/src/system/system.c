@@ -129,15 +129,6 @@ void system_enter_dfu(void)
     NVIC_SystemReset();
 }
 
-void system_reset_calibration(void)
-{
-    ADC_reset();
-    sensors_reset();
-    observers_init_with_defaults();
-    motor_reset_calibration();
-    wait_pwm_cycles(5000);
-}
-
 TM_RAMFUNC float system_get_Vbus(void)
 {
     return state.Vbus;
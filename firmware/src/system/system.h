@@ -37,7 +37,6 @@ void system_init(void);
 void system_update(void);
 void system_reset(void);
 void system_enter_dfu(void);
-void system_reset_calibration(void);
 
 extern const uint32_t config_size;
 
@@ -63,7 +62,6 @@ static inline uint32_t system_get_config_size(void)
     return config_size;
 }
 
-void system_reset_calibration(void);
 float system_get_Vbus(void);
 bool system_get_calibrated(void);
 uint8_t system_get_errors(void);
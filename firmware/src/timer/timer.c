@@ -42,4 +42,23 @@ void timers_init(void)
     PAC55XX_TIMERA->CCTR5.CTR = 0;
     PAC55XX_TIMERA->CCTR6.CTR = 0;
 
+    // Timer B -- one-shot pacing of multi-byte sensor transfers
+    pac5xxx_timer_clock_config(TimerB, TXCTL_CS_ACLK, TXCTL_PS_DIV);
+    PAC55XX_TIMERB->CTL.BASEIE = 1;
+    NVIC_SetPriority(TimerB_IRQn, 1);
+    NVIC_EnableIRQ(TimerB_IRQn);
+}
+
+TM_RAMFUNC void sensor_timer_start(uint16_t ticks)
+{
+    PAC55XX_TIMERB->CTL.MODE = TxCTL_MODE_DISABLED;
+    PAC55XX_TIMERB->CTL.CLR = 1;
+    PAC55XX_TIMERB->PRD.w = ticks;
+    PAC55XX_TIMERB->CTL.SINGLE = SINGLE_SHOT;
+    PAC55XX_TIMERB->CTL.MODE = TxCTL_MODE_UP;
+}
+
+TM_RAMFUNC void sensor_timer_stop(void)
+{
+    PAC55XX_TIMERB->CTL.MODE = TxCTL_MODE_DISABLED;
 }
@@ -38,4 +38,8 @@ typedef enum
     SINGLE_SHOT                         = 1,        // The timer single shot
 }TXCTL_SINGLE_Type;
 
+#define SENSOR_TIMER_TICKS_PER_US (TIMER_FREQ_HZ / 1000000)
+
 void timers_init(void);
+void sensor_timer_start(uint16_t ticks);
+void sensor_timer_stop(void);
@@ -60,6 +60,24 @@ typedef enum
     CONTROLLER_ERRORS_PRE_CL_I_SD_EXCEEDED = (1 << 1)
 } controller_errors_flags;
 
+typedef enum
+{
+    CONTROLLER_CALIBRATION_STAGES_NONE = 0,
+    CONTROLLER_CALIBRATION_STAGES_OFFSET = (1 << 0), 
+    CONTROLLER_CALIBRATION_STAGES_R = (1 << 1), 
+    CONTROLLER_CALIBRATION_STAGES_L = (1 << 2), 
+    CONTROLLER_CALIBRATION_STAGES_SENSORS = (1 << 3), 
+    CONTROLLER_CALIBRATION_STAGES_VERIFY = (1 << 4)
+} controller_calibration_stages_flags;
+
+typedef enum
+{
+    CONTROLLER_CALIBRATION_MISMATCH_NONE = 0,
+    CONTROLLER_CALIBRATION_MISMATCH_OFFSET = (1 << 0), 
+    CONTROLLER_CALIBRATION_MISMATCH_R = (1 << 1), 
+    CONTROLLER_CALIBRATION_MISMATCH_L = (1 << 2)
+} controller_calibration_mismatch_flags;
+
 typedef enum
 {
     MOTOR_ERRORS_NONE = 0,
@@ -104,6 +122,26 @@ typedef enum
     HOMING_WARNINGS_HOMING_TIMEOUT = (1 << 0)
 } homing_warnings_flags;
 
+typedef enum
+{
+    NVM_SAVE_STATE_IDLE = 0,
+    NVM_SAVE_STATE_PREPARING = 1,
+    NVM_SAVE_STATE_WAITING = 2,
+    NVM_SAVE_STATE_ERASING = 3,
+    NVM_SAVE_STATE_WRITING = 4,
+    NVM_SAVE_STATE_FAILED = 5,
+    NVM_SAVE_STATE__MAX
+} nvm_save_state_options;
+
+typedef enum
+{
+    SCHEDULER_DEGRADATION_NONE = 0,
+    SCHEDULER_DEGRADATION_TEMPERATURE = 1,
+    SCHEDULER_DEGRADATION_TRAJECTORY = 2,
+    SCHEDULER_DEGRADATION_RECTIFICATION = 3,
+    SCHEDULER_DEGRADATION__MAX
+} scheduler_degradation_options;
+
 typedef enum
 {
     CONTROLLER_STATE_IDLE = 0,
@@ -122,6 +160,14 @@ typedef enum
     CONTROLLER_MODE__MAX
 } controller_mode_options;
 
+typedef enum
+{
+    CONTROLLER_VOLTAGE_SVM_MODE_CONTINUOUS = 0,
+    CONTROLLER_VOLTAGE_SVM_MODE_DPWMMIN = 1,
+    CONTROLLER_VOLTAGE_SVM_MODE_DPWM1 = 2,
+    CONTROLLER_VOLTAGE_SVM_MODE__MAX
+} controller_voltage_svm_mode_options;
+
 typedef enum
 {
     MOTOR_TYPE_HIGH_CURRENT = 0,
@@ -144,9 +190,17 @@ typedef enum
     SENSORS_SETUP_EXTERNAL_SPI_RATE_6Mbps = 2,
     SENSORS_SETUP_EXTERNAL_SPI_RATE_8Mbps = 3,
     SENSORS_SETUP_EXTERNAL_SPI_RATE_12Mbps = 4,
+    SENSORS_SETUP_EXTERNAL_SPI_RATE_25Mbps = 5,
     SENSORS_SETUP_EXTERNAL_SPI_RATE__MAX
 } sensors_setup_external_spi_rate_options;
 
+typedef enum
+{
+    SENSORS_SETUP_RECTIFICATION_TABLE = 0,
+    SENSORS_SETUP_RECTIFICATION_HARMONIC = 1,
+    SENSORS_SETUP_RECTIFICATION__MAX
+} sensors_setup_rectification_options;
+
 typedef enum
 {
     SENSORS_SELECT_POSITION_SENSOR_CONNECTION_ONBOARD = 0,
@@ -162,3 +216,11 @@ typedef enum
     SENSORS_SELECT_COMMUTATION_SENSOR_CONNECTION_HALL = 2,
     SENSORS_SELECT_COMMUTATION_SENSOR_CONNECTION__MAX
 } sensors_select_commutation_sensor_connection_options;
+
+typedef enum
+{
+    TRAJ_PLANNER_SHAPER_TYPE_NONE = 0,
+    TRAJ_PLANNER_SHAPER_TYPE_ZV = 1,
+    TRAJ_PLANNER_SHAPER_TYPE_ZVD = 2,
+    TRAJ_PLANNER_SHAPER_TYPE__MAX
+} traj_planner_shaper_type_options;
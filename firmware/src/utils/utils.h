@@ -2,8 +2,6 @@
 //  * This file is part of the Tinymovr-Firmware distribution
 //  * (https://github.com/yconst/tinymovr-firmware).
 //  * 
-//  *  *except* for the function "SVM()", which is Copyright (c) 2016-2018 Oskar Weigl
-//  * 
 //  * Copyright (c) 2020-2023 Ioannis Chatzikonstantinou.
 //  * 
 //  * This program is free software: you can redistribute it and/or modify  
@@ -40,6 +38,19 @@ static inline float our_fabsf(float x)
     return x;
 }
 
+#elif defined(TM_HOST_BUILD)
+
+// Host builds of the harnesses under tests/
+static inline float fast_sqrt(float x)
+{
+    return sqrtf(x);
+}
+
+static inline float our_fabsf(float x)
+{
+    return fabsf(x);
+}
+
 #else
 
 #error No math implemented without Arm FPU!
@@ -143,6 +154,36 @@ static inline float fast_sin(float angle)
     return fast_cos(halfpi-angle);
 }
 
+#define SINCOS_TABLE_SIZE (64)
+
+static const float sincos_table[SINCOS_TABLE_SIZE] = {
+    0.00000000f, 0.09801714f, 0.19509032f, 0.29028468f, 0.38268343f, 0.47139674f, 0.55557023f, 0.63439328f,
+    0.70710678f, 0.77301045f, 0.83146961f, 0.88192126f, 0.92387953f, 0.95694034f, 0.98078528f, 0.99518473f,
+    1.00000000f, 0.99518473f, 0.98078528f, 0.95694034f, 0.92387953f, 0.88192126f, 0.83146961f, 0.77301045f,
+    0.70710678f, 0.63439328f, 0.55557023f, 0.47139674f, 0.38268343f, 0.29028468f, 0.19509032f, 0.09801714f,
+    0.00000000f, -0.09801714f, -0.19509032f, -0.29028468f, -0.38268343f, -0.47139674f, -0.55557023f, -0.63439328f,
+    -0.70710678f, -0.77301045f, -0.83146961f, -0.88192126f, -0.92387953f, -0.95694034f, -0.98078528f, -0.99518473f,
+    -1.00000000f, -0.99518473f, -0.98078528f, -0.95694034f, -0.92387953f, -0.88192126f, -0.83146961f, -0.77301045f,
+    -0.70710678f, -0.63439328f, -0.55557023f, -0.47139674f, -0.38268343f, -0.29028468f, -0.19509032f, -0.09801714f};
+
+// Sine and cosine of the same angle, sharing the range reduction. The
+// nearest lower table entry is rotated by the remainder, using short
+// Taylor series that are accurate to 1e-7 for remainders below 2pi/64.
+static inline void fast_sincos(float angle, float *s, float *c)
+{
+    const float x = angle * (SINCOS_TABLE_SIZE * INVTWOPI);
+    const float x_floor = our_floorf(x);
+    const uint32_t i = (uint32_t)(int32_t)x_floor & (SINCOS_TABLE_SIZE - 1);
+    const float d = (x - x_floor) * (TWOPI / SINCOS_TABLE_SIZE);
+    const float d2 = d * d;
+    const float sin_d = d * (1.0f - d2 * (1.0f / 6.0f));
+    const float cos_d = 1.0f - d2 * (0.5f - d2 * (1.0f / 24.0f));
+    const float sin_i = sincos_table[i];
+    const float cos_i = sincos_table[(i + (SINCOS_TABLE_SIZE / 4)) & (SINCOS_TABLE_SIZE - 1)];
+    *s = (sin_i * cos_d) + (cos_i * sin_d);
+    *c = (cos_i * cos_d) - (sin_i * sin_d);
+}
+
 typedef struct {
     float sum_current;
     float sum_current_squared;
@@ -163,159 +204,168 @@ static inline float calculate_standard_deviation(Statistics *s)
     return fast_sqrt(mean_squares - mean * mean);
 }
 
-// https://github.com/madcowswe/ODrive/blob/3113aedf081cf40e942d25d3b0b36c8806f11f23/Firmware/MotorControl/utils.c
-// Released under teh following license:
-// The MIT License (MIT)
+// Convergence check for calibration estimates. Samples are averaged in
+// blocks, and the estimate is taken to have converged once the means of
+// the last CONVERGENCE_BLOCKS blocks have a standard deviation within tol.
+typedef struct {
+    float block_sum;
+    uint32_t block_count;
+    uint32_t blocks;
+    float block_means[CONVERGENCE_BLOCKS];
+} ConvergenceMonitor;
 
-// Copyright (c) 2016-2018 Oskar Weigl
+static inline bool convergence_update(ConvergenceMonitor *m, float sample, uint32_t block_len, float tol)
+{
+    m->block_sum += sample;
+    m->block_count++;
+    if (m->block_count < block_len)
+    {
+        return false;
+    }
+    m->block_means[m->blocks % CONVERGENCE_BLOCKS] = m->block_sum / block_len;
+    m->blocks++;
+    m->block_sum = 0.0f;
+    m->block_count = 0;
+    if (m->blocks < CONVERGENCE_BLOCKS)
+    {
+        return false;
+    }
+    float mean = 0.0f;
+    for (uint8_t i = 0; i < CONVERGENCE_BLOCKS; i++)
+    {
+        mean += m->block_means[i];
+    }
+    mean *= (1.0f / CONVERGENCE_BLOCKS);
+    float var = 0.0f;
+    for (uint8_t i = 0; i < CONVERGENCE_BLOCKS; i++)
+    {
+        const float d = m->block_means[i] - mean;
+        var += d * d;
+    }
+    var *= (1.0f / (CONVERGENCE_BLOCKS - 1));
+    return var <= (tol * tol);
+}
 
-// Permission is hereby granted, free of charge, to any person obtaining a copy
-// of this software and associated documentation files (the "Software"), to deal
-// in the Software without restriction, including without limitation the rights
-// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-// copies of the Software, and to permit persons to whom the Software is
-// furnished to do so, subject to the following conditions:
+// Centered space vector modulation by min-max zero sequence injection.
+// The phase voltages are shifted so that the largest and smallest are
+// symmetric about the center, which gives the same timings as the
+// sector-based formulation without branching on the sector.
+static inline int SVM(float alpha, float beta, float* tA, float* tB, float* tC)
+{
+    const float v_a = -(2.0f / 3.0f) * alpha;
+    const float v_b = (1.0f / 3.0f) * alpha - one_by_sqrt3 * beta;
+    const float v_c = (1.0f / 3.0f) * alpha + one_by_sqrt3 * beta;
 
-// The above copyright notice and this permission notice shall be included in all
-// copies or substantial portions of the Software.
+    const float v_max = our_fmaxf(our_fmaxf(v_a, v_b), v_c);
+    const float v_min = our_fminf(our_fminf(v_a, v_b), v_c);
+    const float offset = 0.5f - 0.5f * (v_max + v_min);
 
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
-// SOFTWARE.
+    *tA = v_a + offset;
+    *tB = v_b + offset;
+    *tC = v_c + offset;
 
-static inline int SVM(float alpha, float beta, float* tA, float* tB, float* tC)
-{
-    int Sextant;
+    // if any of the results becomes NaN, result_valid will evaluate to false
+    int result_valid =
+            *tA >= 0.0f && *tA <= 1.0f
+         && *tB >= 0.0f && *tB <= 1.0f
+         && *tC >= 0.0f && *tC <= 1.0f;
+    return result_valid ? 0 : -1;
+}
 
-    if (beta >= 0.0f)
+// Modulation amplitudes, in the units of the SVM() alpha/beta inputs
+#define SVM_LINEAR_LIMIT   (0.8660254f) // sqrt(3)/2, circle inscribed in the hexagon
+#define SVM_HEXAGON_LIMIT  (0.9085451f) // fundamental when tracing the hexagon
+#define SVM_SIXSTEP_LIMIT  (0.9549297f) // 3/pi, fundamental of six-step
+#define SVM_OVERMOD_TABLE_SIZE (9)
+
+// Reference radius that yields a fundamental evenly spaced between
+// SVM_LINEAR_LIMIT and SVM_HEXAGON_LIMIT after clamping to the hexagon
+static const float svm_overmod_radius[SVM_OVERMOD_TABLE_SIZE] = {
+    0.8660254f, 0.8723f, 0.8798f, 0.8884f, 0.8985f, 0.9105f, 0.9255f, 0.9461f, 1.0000f};
+
+// Space vector modulation extended into the overmodulation region.
+// Below SVM_LINEAR_LIMIT this is identical to SVM(). Up to SVM_HEXAGON_LIMIT
+// the reference is enlarged and clamped to the hexagon while keeping its
+// angle. Beyond that, the middle phase is progressively pulled towards the
+// rail it is closest to, ending in six-step at SVM_SIXSTEP_LIMIT. In both
+// regions the fundamental follows the requested amplitude.
+static inline void SVM_overmodulation(float alpha, float beta, float* tA, float* tB, float* tC)
+{
+    const float amplitude = fast_sqrt((alpha * alpha) + (beta * beta));
+    if (amplitude <= SVM_LINEAR_LIMIT)
     {
-        if (alpha >= 0.0f)
-        {
-            //quadrant I
-            if (one_by_sqrt3 * beta > alpha)
-                Sextant = 2; //sextant v2-v3
-            else
-                Sextant = 1; //sextant v1-v2
+        SVM(alpha, beta, tA, tB, tC);
+        return;
+    }
 
-        }
-        else
-        {
-            //quadrant II
-            if (-one_by_sqrt3 * beta > alpha)
-                Sextant = 3; //sextant v3-v4
-            else
-                Sextant = 2; //sextant v2-v3
-        }
+    float radius = 1.0f;
+    float hold = 0.0f;
+    if (amplitude < SVM_HEXAGON_LIMIT)
+    {
+        const float x = (amplitude - SVM_LINEAR_LIMIT) * ((SVM_OVERMOD_TABLE_SIZE - 1) / (SVM_HEXAGON_LIMIT - SVM_LINEAR_LIMIT));
+        const int i = (int)x;
+        radius = svm_overmod_radius[i] + (x - i) * (svm_overmod_radius[i + 1] - svm_overmod_radius[i]);
     }
     else
     {
-        if (alpha >= 0.0f)
-        {
-            //quadrant IV
-            if (-one_by_sqrt3 * beta > alpha)
-                Sextant = 5; //sextant v5-v6
-            else
-                Sextant = 6; //sextant v6-v1
-        }
-        else
-        {
-            //quadrant III
-            if (one_by_sqrt3 * beta > alpha)
-                Sextant = 4; //sextant v4-v5
-            else
-                Sextant = 5; //sextant v5-v6
-        }
+        hold = our_fminf((amplitude - SVM_HEXAGON_LIMIT) * (1.0f / (SVM_SIXSTEP_LIMIT - SVM_HEXAGON_LIMIT)), 1.0f);
+    }
+    const float scale = radius / amplitude;
+    SVM(alpha * scale, beta * scale, tA, tB, tC);
+
+    // Clamp to the hexagon by shrinking the vector about the center
+    const float t_max = our_fmaxf(our_fmaxf(*tA, *tB), *tC);
+    const float t_min = our_fminf(our_fminf(*tA, *tB), *tC);
+    const float span = t_max - t_min;
+    if (span > 1.0f)
+    {
+        const float inv_span = 1.0f / span;
+        *tA = 0.5f + (*tA - 0.5f) * inv_span;
+        *tB = 0.5f + (*tB - 0.5f) * inv_span;
+        *tC = 0.5f + (*tC - 0.5f) * inv_span;
     }
 
-    switch (Sextant)
+    if (hold > 0.0f)
     {
-        // sextant v1-v2
-        case 1:
-        {
-            // Vector on-times
-            float t1 = alpha - one_by_sqrt3 * beta;
-            float t2 = two_by_sqrt3 * beta;
-
-            // PWM timings
-            *tA = (1.0f - t1 - t2) * 0.5f;
-            *tB = *tA + t1;
-            *tC = *tB + t2;
-        } break;
-
-        // sextant v2-v3
-        case 2:
+        // Pull the middle phase towards the nearest vertex
+        float *t_mid = tC;
+        if ((*tA - *tB) * (*tA - *tC) <= 0.0f)
         {
-            // Vector on-times
-            float t2 = alpha + one_by_sqrt3 * beta;
-            float t3 = -alpha + one_by_sqrt3 * beta;
-
-            // PWM timings
-            *tB = (1.0f - t2 - t3) * 0.5f;
-            *tA = *tB + t3;
-            *tC = *tA + t2;
-        } break;
-
-        // sextant v3-v4
-        case 3:
-        {
-            // Vector on-times
-            float t3 = two_by_sqrt3 * beta;
-            float t4 = -alpha - one_by_sqrt3 * beta;
-
-            // PWM timings
-            *tB = (1.0f - t3 - t4) * 0.5f;
-            *tC = *tB + t3;
-            *tA = *tC + t4;
-        } break;
-
-        // sextant v4-v5
-        case 4:
-        {
-            // Vector on-times
-            float t4 = -alpha + one_by_sqrt3 * beta;
-            float t5 = -two_by_sqrt3 * beta;
-
-            // PWM timings
-            *tC = (1.0f - t4 - t5) * 0.5f;
-            *tB = *tC + t5;
-            *tA = *tB + t4;
-        } break;
-
-        // sextant v5-v6
-        case 5:
-        {
-            // Vector on-times
-            float t5 = -alpha - one_by_sqrt3 * beta;
-            float t6 = alpha - one_by_sqrt3 * beta;
-
-            // PWM timings
-            *tC = (1.0f - t5 - t6) * 0.5f;
-            *tA = *tC + t5;
-            *tB = *tA + t6;
-        } break;
-
-        // sextant v6-v1
-        case 6:
+            t_mid = tA;
+        }
+        else if ((*tB - *tA) * (*tB - *tC) <= 0.0f)
         {
-            // Vector on-times
-            float t6 = -two_by_sqrt3 * beta;
-            float t1 = alpha + one_by_sqrt3 * beta;
-
-            // PWM timings
-            *tA = (1.0f - t6 - t1) * 0.5f;
-            *tC = *tA + t1;
-            *tB = *tC + t6;
-        } break;
+            t_mid = tB;
+        }
+        const float rail = *t_mid >= 0.5f ? 1.0f : 0.0f;
+        *t_mid += hold * (rail - *t_mid);
     }
+}
 
-    // if any of the results becomes NaN, result_valid will evaluate to false
-    int result_valid =
-            *tA >= 0.0f && *tA <= 1.0f
-         && *tB >= 0.0f && *tB <= 1.0f
-         && *tC >= 0.0f && *tC <= 1.0f;
-    return result_valid ? 0 : -1;
+// Discontinuous PWM, DPWMMIN: shift the zero sequence so that the phase
+// with the lowest duty is held at the low rail. The low-side switches stay
+// on for that phase, so all shunts remain measurable.
+static inline void SVM_clamp_min(float* tA, float* tB, float* tC)
+{
+    const float shift = -our_fminf(our_fminf(*tA, *tB), *tC);
+    *tA += shift;
+    *tB += shift;
+    *tC += shift;
+}
+
+// Discontinuous PWM, DPWM1: clamp the phase with the largest voltage
+// magnitude to its rail, in 60 degree segments centered on the voltage
+// peaks. Near unity power factor this avoids switching the phase while
+// it carries its peak current.
+static inline void SVM_clamp_peak(float* tA, float* tB, float* tC)
+{
+    const float t_max = our_fmaxf(our_fmaxf(*tA, *tB), *tC);
+    const float t_min = our_fminf(our_fminf(*tA, *tB), *tC);
+    const float t_mid = *tA + *tB + *tC - t_max - t_min;
+    // The centered middle phase lies on the opposite side of the extreme
+    // with the largest magnitude.
+    const float shift = (t_mid - 0.5f * (t_max + t_min)) < 0.0f ? (1.0f - t_max) : -t_min;
+    *tA += shift;
+    *tB += shift;
+    *tC += shift;
 }
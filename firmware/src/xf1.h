@@ -1,6 +1,8 @@
 #pragma once
 
 #include <math.h> // For fabsf() - single precision absolute value
+#include <src/common.h>
+#include <src/utils/utils.h>
 
 #define DEFAULT_TRANSFORM (FrameTransform){.offset = 0.0f, .multiplier = 1.0f}
 
@@ -82,3 +84,44 @@ static inline FrameTransform combine_transforms(const FrameTransform* first, con
     
     return combined;
 }
+
+// Brings ticks back within [0, SENSOR_COMMON_RES_TICKS), carrying whole turns
+static inline void turn_position_normalize(TurnPosition *p) {
+    if ((p->ticks < 0.0f) || (p->ticks >= SENSOR_COMMON_RES_TICKS_FLOAT)) {
+        const float turns = our_floorf(p->ticks * (1.0f / SENSOR_COMMON_RES_TICKS_FLOAT));
+        p->turns += (int32_t)turns;
+        p->ticks -= turns * SENSOR_COMMON_RES_TICKS_FLOAT;
+        // Rounding may land a tiny negative remainder exactly on the upper
+        // bound, and our_floorf() rounds negative whole numbers one lower
+        if (p->ticks >= SENSOR_COMMON_RES_TICKS_FLOAT) {
+            p->ticks -= SENSOR_COMMON_RES_TICKS_FLOAT;
+            p->turns += 1;
+        }
+    }
+}
+
+// Function to set a turn position from a single float position in ticks
+static inline void turn_position_from_ticks(TurnPosition *p, float ticks) {
+    p->turns = 0;
+    p->ticks = ticks;
+    turn_position_normalize(p);
+}
+
+// Function to collapse a turn position into a single float position in ticks.
+// Precision is lost once the position exceeds 2^24 ticks.
+static inline float turn_position_to_ticks(const TurnPosition *p) {
+    return (SENSOR_COMMON_RES_TICKS_FLOAT * p->turns) + p->ticks;
+}
+
+// Function to offset a turn position by a distance in ticks
+static inline void turn_position_add(TurnPosition *p, float delta) {
+    p->ticks += delta;
+    turn_position_normalize(p);
+}
+
+// Function to compute the distance a - b in ticks. The turn difference is
+// taken in integers, so the result is exact for nearby positions regardless
+// of how far they are from the origin.
+static inline float turn_position_diff(const TurnPosition *a, const TurnPosition *b) {
+    return (SENSOR_COMMON_RES_TICKS_FLOAT * (float)(a->turns - b->turns)) + (a->ticks - b->ticks);
+}
@@ -0,0 +1,75 @@
+
+//  * This file is part of the Tinymovr-Firmware distribution
+//  * (https://github.com/yconst/tinymovr-firmware).
+//  * Copyright (c) 2020-2023 Ioannis Chatzikonstantinou.
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation, version 3.
+//  *
+//  * This program is distributed in the hope that it will be useful, but
+//  * WITHOUT ANY WARRANTY; without even the implied warranty of
+//  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+//  * General Public License for more details.
+//  *
+//  * You should have received a copy of the GNU General Public License
+//  * along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// Stand-in for src/common.h in host builds. It takes precedence on the
+// include path, so that header-only firmware code such as src/utils/utils.h
+// can be built without the PAC SDK. Only the definitions that code needs
+// are mirrored here; keep them in sync with src/common.h.
+
+#ifndef COMMON_H
+#define COMMON_H
+
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "src/config.h"
+
+#define ALWAYS_INLINE __attribute__((always_inline))
+#define TM_RAMFUNC
+
+#define PI (3.141592f)
+#define TWOPI (6.283185f)
+#define INVTWOPI (0.159155f)
+
+#define PWM_PERIOD_S (1.0f / PWM_FREQ_HZ)
+
+#define SENSOR_COMMON_RES_BITS (13)
+#define SENSOR_COMMON_RES_TICKS (1 << SENSOR_COMMON_RES_BITS)
+#define SENSOR_COMMON_RES_HALF_TICKS (SENSOR_COMMON_RES_TICKS/2)
+#define SENSOR_COMMON_RES_TICKS_FLOAT ((float)(SENSOR_COMMON_RES_TICKS))
+
+static const float one_by_sqrt3 = 0.57735026919f;
+static const float two_by_sqrt3 = 1.15470053838f;
+static const float threehalfpi = 4.7123889f;
+static const float pi = PI;
+static const float halfpi = PI * 0.5f;
+static const float quarterpi = PI * 0.25f;
+static const float twopi_by_common_ticks = TWOPI / SENSOR_COMMON_RES_TICKS;
+
+typedef struct
+{
+	float A;
+	float B;
+	float C;
+} FloatTriplet;
+
+typedef struct
+{
+	int32_t turns;
+	float ticks;
+} TurnPosition;
+
+static inline void pac_delay_asm(uint32_t count)
+{
+    (void)count;
+}
+
+#endif // #ifndef COMMON_H
@@ -0,0 +1,29 @@
+
+//  * This file is part of the Tinymovr-Firmware distribution
+//  * (https://github.com/yconst/tinymovr-firmware).
+//  * Copyright (c) 2020-2023 Ioannis Chatzikonstantinou.
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation, version 3.
+//  *
+//  * This program is distributed in the hope that it will be useful, but
+//  * WITHOUT ANY WARRANTY; without even the implied warranty of
+//  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+//  * General Public License for more details.
+//  *
+//  * You should have received a copy of the GNU General Public License
+//  * along with this program. If not, see <http://www.gnu.org/licenses/>.
+// Stand-in for src/system/system.h in host builds. The firmware header
+// reads device registers in its inline functions; only the declarations
+// the planner and controller code need are kept here.
+
+#ifndef SYSTEM_SYSTEM_H_
+#define SYSTEM_SYSTEM_H_
+
+#include <string.h>
+#include <src/common.h>
+
+bool errors_exist(void);
+
+#endif /* SYSTEM_SYSTEM_H_ */
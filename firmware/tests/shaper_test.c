@@ -0,0 +1,180 @@
+
+//  * This file is part of the Tinymovr-Firmware distribution
+//  * (https://github.com/yconst/tinymovr-firmware).
+//  * Copyright (c) 2020-2023 Ioannis Chatzikonstantinou.
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation, version 3.
+//  *
+//  * This program is distributed in the hope that it will be useful, but
+//  * WITHOUT ANY WARRANTY; without even the implied warranty of
+//  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+//  * General Public License for more details.
+//  *
+//  * You should have received a copy of the GNU General Public License
+//  * along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// Host test of the trajectory planner input shaper. Moves are started
+// while the setpoint is already moving, and the setpoint must continue
+// without a step in position or velocity, with the position following
+// the integral of the velocity setpoint. Exits non-zero on failure.
+
+#include "src/controller/trajectory_planner.c"
+
+// Per-cycle position increment may change by no more than the
+// acceleration limit allows, plus float rounding of the setpoint
+#define ACCEL_MAX         (SENSOR_COMMON_RES_TICKS_FLOAT)
+#define STEP_TOL          (0.01)     // ticks
+#define VEL_TOL           (0.01)     // ticks/s
+#define TRACK_TOL         (2.0)      // ticks, decimated history interpolation
+#define TARGET_TOL        (0.5)      // ticks
+#define LEAD_IN_CYCLES    (100)
+
+// Minimal controller, in a user frame identical to the sensor frame
+FramesConfig frames = {
+    .position_sensor_to_user = DEFAULT_TRANSFORM,
+    .user_to_position_sensor = DEFAULT_TRANSFORM};
+
+static double pos_setpoint;
+static float vel_setpoint;
+static MotionPlan plan;
+static bool trajectory_mode;
+
+bool errors_exist(void)
+{
+    return false;
+}
+
+float controller_get_vel_limit(void)
+{
+    return 1.0e6f;
+}
+
+void controller_get_pos_setpoint(TurnPosition *pos)
+{
+    pos->turns = (int32_t)floor(pos_setpoint / SENSOR_COMMON_RES_TICKS);
+    pos->ticks = (float)(pos_setpoint - (double)pos->turns * SENSOR_COMMON_RES_TICKS);
+}
+
+float controller_get_pos_setpoint_user_frame(void)
+{
+    return (float)pos_setpoint;
+}
+
+void controller_set_pos_setpoint_relative_user_frame(const TurnPosition *origin, float offset)
+{
+    pos_setpoint = (double)origin->turns * SENSOR_COMMON_RES_TICKS + origin->ticks + offset;
+}
+
+float controller_get_vel_setpoint_user_frame(void)
+{
+    return vel_setpoint;
+}
+
+void controller_set_vel_setpoint_user_frame(float value)
+{
+    vel_setpoint = value;
+}
+
+void controller_set_motion_plan(MotionPlan mp)
+{
+    plan = mp;
+}
+
+void controller_set_mode(controller_mode_options mode)
+{
+    trajectory_mode = (mode == CONTROLLER_MODE_TRAJECTORY);
+}
+
+static int failures;
+
+#define CHECK(cond, ...) do { if (!(cond)) { failures++; printf("FAIL: " __VA_ARGS__); printf("\n"); } } while (0)
+
+static const char *shaper_names[] = {"none", "ZV", "ZVD"};
+
+// Runs the setpoint at v_0 in velocity mode, starts a move by distance,
+// and evaluates it to the end as CLControlStep() does.
+static void run_move(uint8_t shaper_type, bool vlimit, float v_0, float distance)
+{
+    const char *name = vlimit ? "vlimit" : "tlimit";
+    planner_set_shaper_type(shaper_type);
+    pos_setpoint = 1000.0;
+    vel_setpoint = v_0;
+    double prev_pos = pos_setpoint;
+    double prev_delta = v_0 * PWM_PERIOD_S;
+    double worst_step = 0.0;
+    double worst_vel = 0.0;
+    double worst_track = 0.0;
+    for (int i = 0; i < LEAD_IN_CYCLES; i++)
+    {
+        pos_setpoint += v_0 * PWM_PERIOD_S;
+        prev_delta = pos_setpoint - prev_pos;
+        prev_pos = pos_setpoint;
+    }
+    const double start = pos_setpoint;
+    const bool ok = vlimit ? planner_move_by_vlimit(distance) : planner_move_by_tlimit(distance);
+    CHECK(ok && trajectory_mode, "%s %s v_0=%.0f: move rejected", shaper_names[shaper_type], name, v_0);
+    float prev_vel = v_0;
+    double integral = start;
+    float t = 0.0f;
+    while (trajectory_mode)
+    {
+        // Integrate over the float time steps the planner actually sees
+        const float t_prev = t;
+        t += PWM_PERIOD_S;
+        if (!traj_planner_evaluate(t, &plan))
+        {
+            controller_set_mode(CONTROLLER_MODE_POSITION);
+            break;
+        }
+        const double delta = pos_setpoint - prev_pos;
+        worst_step = fmax(worst_step, fabs(delta - prev_delta));
+        worst_vel = fmax(worst_vel, fabs((double)vel_setpoint - prev_vel));
+        integral += 0.5 * ((double)vel_setpoint + prev_vel) * ((double)t - t_prev);
+        worst_track = fmax(worst_track, fabs(pos_setpoint - integral));
+        prev_delta = delta;
+        prev_pos = pos_setpoint;
+        prev_vel = vel_setpoint;
+    }
+    const double step_limit = ACCEL_MAX * PWM_PERIOD_S * PWM_PERIOD_S + STEP_TOL;
+    const double vel_limit = ACCEL_MAX * PWM_PERIOD_S + VEL_TOL;
+    CHECK(worst_step <= step_limit, "%s %s v_0=%.0f: setpoint steps by %.3f ticks",
+        shaper_names[shaper_type], name, v_0, worst_step);
+    CHECK(worst_vel <= vel_limit, "%s %s v_0=%.0f: velocity setpoint steps by %.3f ticks/s",
+        shaper_names[shaper_type], name, v_0, worst_vel);
+    CHECK(worst_track <= TRACK_TOL, "%s %s v_0=%.0f: setpoint departs from the velocity integral by %.3f ticks",
+        shaper_names[shaper_type], name, v_0, worst_track);
+    if (!vlimit)
+    {
+        const double end = pos_setpoint - start;
+        CHECK(fabs(end - distance) <= TARGET_TOL, "%s %s v_0=%.0f: ends %.3f ticks from the target",
+            shaper_names[shaper_type], name, v_0, end - distance);
+    }
+}
+
+int main(void)
+{
+    static const float velocities[] = {0.0f, 2000.0f, -3000.0f};
+    planner_set_max_accel(ACCEL_MAX);
+    planner_set_max_decel(ACCEL_MAX);
+    planner_set_max_vel(5000.0f);
+    planner_set_shaper_frequency(5.0f);
+    planner_set_shaper_damping(0.1f);
+    for (uint8_t type = TRAJ_PLANNER_SHAPER_TYPE_NONE; type < TRAJ_PLANNER_SHAPER_TYPE__MAX; type++)
+    {
+        for (size_t v = 0; v < sizeof(velocities) / sizeof(velocities[0]); v++)
+        {
+            run_move(type, false, velocities[v], 20000.0f);
+            run_move(type, true, velocities[v], 20000.0f);
+            run_move(type, true, velocities[v], -20000.0f);
+        }
+    }
+    if (failures > 0)
+    {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All shaper checks passed\n");
+    return 0;
+}
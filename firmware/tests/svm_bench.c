@@ -0,0 +1,275 @@
+
+//  * This file is part of the Tinymovr-Firmware distribution
+//  * (https://github.com/yconst/tinymovr-firmware).
+//  * Copyright (c) 2020-2023 Ioannis Chatzikonstantinou.
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation, version 3.
+//  *
+//  * This program is distributed in the hope that it will be useful, but
+//  * WITHOUT ANY WARRANTY; without even the implied warranty of
+//  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+//  * General Public License for more details.
+//  *
+//  * You should have received a copy of the GNU General Public License
+//  * along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// Host benchmark of the modulation math in src/utils/utils.h. Compares
+// fast_sincos() against fast_sin()/fast_cos(), and SVM() against the
+// sector-based SVM_sector() it replaced, for accuracy, line-to-line THD
+// and execution time. Timings are for the host; the Cortex-M4 has no
+// branch prediction, so branchy code fares worse there than here.
+
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC
+#endif
+#include "svm_reference.h"
+
+#define ANGLE_RANGE       (50.0f)    // rad, either side of zero
+#define ANGLE_STEPS       (1000000)
+#define THD_SAMPLES       (2000)     // Per electrical cycle
+#define THD_HARMONICS     (50)
+#define TIMING_CALLS      (10000000)
+#define TIMING_INPUTS     (4096)     // Power of two
+
+typedef void (*SinCosFunc)(float angle, float *s, float *c);
+typedef int (*SVMFunc)(float alpha, float beta, float *tA, float *tB, float *tC);
+
+static void sincos_libm(float angle, float *s, float *c)
+{
+    *s = (float)sin((double)angle);
+    *c = (float)cos((double)angle);
+}
+
+static void sincos_separate(float angle, float *s, float *c)
+{
+    *s = fast_sin(angle);
+    *c = fast_cos(angle);
+}
+
+static void sincos_fast(float angle, float *s, float *c)
+{
+    fast_sincos(angle, s, c);
+}
+
+static int svm_sector(float alpha, float beta, float *tA, float *tB, float *tC)
+{
+    return SVM_sector(alpha, beta, tA, tB, tC);
+}
+
+static int svm_minmax(float alpha, float beta, float *tA, float *tB, float *tC)
+{
+    return SVM(alpha, beta, tA, tB, tC);
+}
+
+static const struct { const char *name; SinCosFunc func; } sincos_funcs[] = {
+    {"libm sin/cos", sincos_libm},
+    {"fast_sin/fast_cos", sincos_separate},
+    {"fast_sincos", sincos_fast}};
+
+static const struct { const char *name; SVMFunc func; } svm_funcs[] = {
+    {"SVM_sector", svm_sector},
+    {"SVM", svm_minmax}};
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static double now_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec * 1e9 + (double)t.tv_nsec;
+}
+
+static uint64_t now_ticks(void)
+{
+#if defined(HAVE_TSC)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static double wrap_angle(double a)
+{
+    return a - 2.0 * M_PI * floor((a + M_PI) / (2.0 * M_PI));
+}
+
+static void report_sincos_accuracy(void)
+{
+    printf("Sine/cosine accuracy, angles in [-%.0f, %.0f] rad\n", ANGLE_RANGE, ANGLE_RANGE);
+    printf("  %-20s %14s %14s\n", "function", "max angle err", "max value err");
+    for (size_t f = 1; f < COUNT(sincos_funcs); f++)
+    {
+        double max_angle_err = 0.0;
+        double max_value_err = 0.0;
+        for (uint32_t i = 0; i <= ANGLE_STEPS; i++)
+        {
+            const float angle = -ANGLE_RANGE + (2.0f * ANGLE_RANGE * i) / ANGLE_STEPS;
+            float s, c;
+            sincos_funcs[f].func(angle, &s, &c);
+            const double angle_err = fabs(wrap_angle(atan2((double)s, (double)c) - (double)angle));
+            const double value_err = fmax(fabs((double)s - sin((double)angle)), fabs((double)c - cos((double)angle)));
+            max_angle_err = fmax(max_angle_err, angle_err);
+            max_value_err = fmax(max_value_err, value_err);
+        }
+        printf("  %-20s %14.3e %14.3e\n", sincos_funcs[f].name, max_angle_err, max_value_err);
+    }
+}
+
+static void report_svm_agreement(void)
+{
+    double max_diff = 0.0;
+    int validity_mismatches = 0;
+    for (int i = -200; i <= 200; i++)
+    {
+        for (int j = -200; j <= 200; j++)
+        {
+            const float alpha = i * (1.2f / 200);
+            const float beta = j * (1.2f / 200);
+            float a1, b1, c1, a2, b2, c2;
+            const int r1 = SVM_sector(alpha, beta, &a1, &b1, &c1);
+            const int r2 = SVM(alpha, beta, &a2, &b2, &c2);
+            validity_mismatches += (r1 != r2);
+            max_diff = fmax(max_diff, fabs((double)a1 - a2));
+            max_diff = fmax(max_diff, fabs((double)b1 - b2));
+            max_diff = fmax(max_diff, fabs((double)c1 - c2));
+        }
+    }
+    printf("\nSVM vs SVM_sector over alpha, beta in [-1.2, 1.2]\n");
+    printf("  max duty difference %.3e, validity mismatches %d\n", max_diff, validity_mismatches);
+}
+
+// Total harmonic distortion of the A-B line-to-line voltage over one
+// electrical cycle, from a direct DFT of harmonics 1 to THD_HARMONICS.
+static double line_thd(SinCosFunc sc, SVMFunc svm, float amplitude, float phase_offset)
+{
+    static double v_ab[THD_SAMPLES];
+    for (uint32_t n = 0; n < THD_SAMPLES; n++)
+    {
+        const float angle = phase_offset + (TWOPI * n) / THD_SAMPLES;
+        float s, c, tA, tB, tC;
+        sc(angle, &s, &c);
+        svm(amplitude * c, amplitude * s, &tA, &tB, &tC);
+        v_ab[n] = (double)tA - (double)tB;
+    }
+    double fundamental = 0.0;
+    double harmonics = 0.0;
+    for (uint32_t h = 1; h <= THD_HARMONICS; h++)
+    {
+        double re = 0.0;
+        double im = 0.0;
+        for (uint32_t n = 0; n < THD_SAMPLES; n++)
+        {
+            const double w = 2.0 * M_PI * h * n / THD_SAMPLES;
+            re += v_ab[n] * cos(w);
+            im += v_ab[n] * sin(w);
+        }
+        const double power = re * re + im * im;
+        if (h == 1)
+        {
+            fundamental = power;
+        }
+        else
+        {
+            harmonics += power;
+        }
+    }
+    return sqrt(harmonics / fundamental);
+}
+
+static void report_thd(void)
+{
+    static const float amplitudes[] = {0.2f, 0.5f, 0.8f};
+    // Large offsets exercise range reduction at the phase angles the
+    // current loop sees after many turns
+    static const float offsets[] = {0.0f, 1000.0f};
+    printf("\nLine-to-line THD, %d harmonics\n", THD_HARMONICS);
+    printf("  %-20s %-12s %9s", "sin/cos", "svm", "offset");
+    for (size_t a = 0; a < COUNT(amplitudes); a++)
+    {
+        printf("    m=%.1f", amplitudes[a]);
+    }
+    printf("\n");
+    for (size_t o = 0; o < COUNT(offsets); o++)
+    {
+        for (size_t f = 0; f < COUNT(sincos_funcs); f++)
+        {
+            for (size_t v = 0; v < COUNT(svm_funcs); v++)
+            {
+                printf("  %-20s %-12s %9.0f", sincos_funcs[f].name, svm_funcs[v].name, offsets[o]);
+                for (size_t a = 0; a < COUNT(amplitudes); a++)
+                {
+                    printf(" %7.4f%%", 100.0 * line_thd(sincos_funcs[f].func, svm_funcs[v].func, amplitudes[a], offsets[o]));
+                }
+                printf("\n");
+            }
+        }
+    }
+}
+
+static volatile float sink;
+
+static void report_timing(void)
+{
+    printf("\nHost timing, %d calls\n", TIMING_CALLS);
+    printf("  %-20s %10s %14s\n", "function", "ns/call", "cycles/call");
+    for (size_t f = 1; f < COUNT(sincos_funcs); f++)
+    {
+        float acc = 0.0f;
+        const double t0 = now_ns();
+        const uint64_t k0 = now_ticks();
+        for (uint32_t i = 0; i < TIMING_CALLS; i++)
+        {
+            float s, c;
+            sincos_funcs[f].func(i * 1e-5f, &s, &c);
+            acc += s + c;
+        }
+        const uint64_t k1 = now_ticks();
+        const double t1 = now_ns();
+        sink = acc;
+        printf("  %-20s %10.2f %14.1f\n", sincos_funcs[f].name,
+            (t1 - t0) / TIMING_CALLS, (double)(k1 - k0) / TIMING_CALLS);
+    }
+    // Inputs sweep all sectors so that branch history cannot settle
+    static float alphas[TIMING_INPUTS];
+    static float betas[TIMING_INPUTS];
+    for (uint32_t i = 0; i < TIMING_INPUTS; i++)
+    {
+        const double angle = i * 2.3999632;
+        alphas[i] = (float)(0.7 * cos(angle));
+        betas[i] = (float)(0.7 * sin(angle));
+    }
+    for (size_t v = 0; v < COUNT(svm_funcs); v++)
+    {
+        float acc = 0.0f;
+        const double t0 = now_ns();
+        const uint64_t k0 = now_ticks();
+        for (uint32_t i = 0; i < TIMING_CALLS; i++)
+        {
+            const uint32_t k = i & (TIMING_INPUTS - 1);
+            float tA, tB, tC;
+            svm_funcs[v].func(alphas[k], betas[k], &tA, &tB, &tC);
+            acc += tA - tB + tC;
+        }
+        const uint64_t k1 = now_ticks();
+        const double t1 = now_ns();
+        sink = acc;
+        printf("  %-20s %10.2f %14.1f\n", svm_funcs[v].name,
+            (t1 - t0) / TIMING_CALLS, (double)(k1 - k0) / TIMING_CALLS);
+    }
+#if !defined(HAVE_TSC)
+    printf("  No cycle counter on this host, cycles/call not measured.\n");
+#endif
+}
+
+int main(void)
+{
+    report_sincos_accuracy();
+    report_svm_agreement();
+    report_thd();
+    report_timing();
+    return 0;
+}
@@ -0,0 +1,156 @@
+
+//  * This file is part of the Tinymovr-Firmware distribution
+//  * (https://github.com/yconst/tinymovr-firmware).
+//  * Copyright (c) 2020-2023 Ioannis Chatzikonstantinou.
+//  *
+//  * This program is free software: you can redistribute it and/or modify
+//  * it under the terms of the GNU General Public License as published by
+//  * the Free Software Foundation, version 3.
+//  *
+//  * This program is distributed in the hope that it will be useful, but
+//  * WITHOUT ANY WARRANTY; without even the implied warranty of
+//  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+//  * General Public License for more details.
+//  *
+//  * You should have received a copy of the GNU General Public License
+//  * along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+// Host test of SVM_overmodulation(), SVM_clamp_min() and SVM_clamp_peak().
+// Exits non-zero on failure.
+
+#include "src/utils/utils.h"
+
+#define ANGLE_SAMPLES     (3600)     // Per electrical cycle
+#define AMPLITUDE_STEPS   (200)
+#define AMPLITUDE_MAX     (1.0f)     // Beyond SVM_SIXSTEP_LIMIT
+#define DUTY_TOL          (1e-6)
+#define LINE_TOL          (1e-5)
+#define FUNDAMENTAL_TOL   (2e-3)     // Relative to the requested amplitude
+
+// Line-to-line fundamental per unit of SVM() amplitude
+#define LINE_GAIN         (1.1547005) // 2/sqrt(3)
+
+typedef enum {
+    CLAMP_NONE = 0,
+    CLAMP_MIN = 1,
+    CLAMP_PEAK = 2
+} ClampMode;
+
+static const char *clamp_names[] = {"continuous", "clamp_min", "clamp_peak"};
+
+static int failures;
+
+#define CHECK(cond, ...) do { if (!(cond)) { failures++; printf("FAIL: " __VA_ARGS__); printf("\n"); } } while (0)
+
+static void modulate(float amplitude, float angle, ClampMode mode, float *tA, float *tB, float *tC)
+{
+    SVM_overmodulation(amplitude * cosf(angle), amplitude * sinf(angle), tA, tB, tC);
+    if (mode == CLAMP_MIN)
+    {
+        SVM_clamp_min(tA, tB, tC);
+    }
+    else if (mode == CLAMP_PEAK)
+    {
+        SVM_clamp_peak(tA, tB, tC);
+    }
+}
+
+static void test_duty_range(void)
+{
+    for (int mode = CLAMP_NONE; mode <= CLAMP_PEAK; mode++)
+    {
+        double worst = 0.0;
+        for (int k = 0; k <= AMPLITUDE_STEPS; k++)
+        {
+            const float amplitude = (AMPLITUDE_MAX * k) / AMPLITUDE_STEPS;
+            for (int n = 0; n < ANGLE_SAMPLES; n++)
+            {
+                float t[3];
+                modulate(amplitude, (TWOPI * n) / ANGLE_SAMPLES, (ClampMode)mode, &t[0], &t[1], &t[2]);
+                for (int p = 0; p < 3; p++)
+                {
+                    worst = fmax(worst, fmax(-(double)t[p], (double)t[p] - 1.0));
+                    CHECK(t[p] == t[p], "%s: NaN duty at m=%.4f", clamp_names[mode], amplitude);
+                }
+            }
+        }
+        CHECK(worst <= DUTY_TOL, "%s: duty outside [0, 1] by %.3e", clamp_names[mode], worst);
+    }
+}
+
+static void test_linear_region(void)
+{
+    for (int mode = CLAMP_NONE; mode <= CLAMP_PEAK; mode++)
+    {
+        double worst = 0.0;
+        for (int k = 0; k <= AMPLITUDE_STEPS; k++)
+        {
+            const float amplitude = (SVM_LINEAR_LIMIT * k) / AMPLITUDE_STEPS;
+            for (int n = 0; n < ANGLE_SAMPLES; n++)
+            {
+                const float angle = (TWOPI * n) / ANGLE_SAMPLES;
+                float a, b, c, ref_a, ref_b, ref_c;
+                modulate(amplitude, angle, (ClampMode)mode, &a, &b, &c);
+                SVM(amplitude * cosf(angle), amplitude * sinf(angle), &ref_a, &ref_b, &ref_c);
+                worst = fmax(worst, fabs(((double)a - b) - ((double)ref_a - ref_b)));
+                worst = fmax(worst, fabs(((double)b - c) - ((double)ref_b - ref_c)));
+                worst = fmax(worst, fabs(((double)c - a) - ((double)ref_c - ref_a)));
+            }
+        }
+        CHECK(worst <= LINE_TOL, "%s: line-to-line differs from SVM() by %.3e", clamp_names[mode], worst);
+    }
+}
+
+// Amplitude of the A-B line-to-line fundamental, in units of the
+// SVM() alpha/beta inputs
+static double fundamental(float amplitude, ClampMode mode)
+{
+    double re = 0.0;
+    double im = 0.0;
+    for (int n = 0; n < ANGLE_SAMPLES; n++)
+    {
+        const float angle = (TWOPI * n) / ANGLE_SAMPLES;
+        float a, b, c;
+        modulate(amplitude, angle, mode, &a, &b, &c);
+        const double w = 2.0 * M_PI * n / ANGLE_SAMPLES;
+        re += ((double)a - b) * cos(w);
+        im += ((double)a - b) * sin(w);
+    }
+    return 2.0 * sqrt(re * re + im * im) / (ANGLE_SAMPLES * LINE_GAIN);
+}
+
+static void test_overmodulation_region(void)
+{
+    for (int mode = CLAMP_NONE; mode <= CLAMP_PEAK; mode++)
+    {
+        double worst = 0.0;
+        double last = 0.0;
+        for (int k = 0; k <= AMPLITUDE_STEPS; k++)
+        {
+            const float amplitude = SVM_LINEAR_LIMIT + ((AMPLITUDE_MAX - SVM_LINEAR_LIMIT) * k) / AMPLITUDE_STEPS;
+            const double expected = fmin(amplitude, SVM_SIXSTEP_LIMIT);
+            const double actual = fundamental(amplitude, (ClampMode)mode);
+            worst = fmax(worst, fabs(actual - expected) / expected);
+            CHECK(actual >= last - 1e-6, "%s: fundamental drops to %.5f at m=%.4f",
+                clamp_names[mode], actual, amplitude);
+            last = actual;
+        }
+        CHECK(worst <= FUNDAMENTAL_TOL, "%s: fundamental off the request by %.3e",
+            clamp_names[mode], worst);
+        printf("%-12s max relative fundamental error above the linear limit: %.3e\n", clamp_names[mode], worst);
+    }
+}
+
+int main(void)
+{
+    test_duty_range();
+    test_linear_region();
+    test_overmodulation_region();
+    if (failures > 0)
+    {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All SVM checks passed\n");
+    return 0;
+}
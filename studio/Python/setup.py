@@ -67,7 +67,9 @@ setup(
         "console_scripts": [
             "tinymovr_cli=tinymovr.cli:spawn",
             "tinymovr=tinymovr.gui:spawn",
-            "tinymovr_dfu=tinymovr.dfu:spawn"
+            "tinymovr_dfu=tinymovr.dfu:spawn",
+            "tinymovr_eccentricity=tinymovr.eccentricity:spawn",
+            "tinymovr_nvm=tinymovr.nvm_image:spawn"
         ]
     },
 )
@@ -250,6 +250,39 @@ class TestBoard(TMTestCase):
         if (self.tm.scheduler.load == 0 or self.tm.scheduler.load > 7000):
             self.skipTest("Invalid timing values. Skipping test.")
         self.assertLess(self.tm.scheduler.load, 4000)
+        # No optional work should be shed at this load
+        self.assertEqual(self.tm.scheduler.degradation, 0)
+
+    @pytest.mark.hitl_default
+    def test_h_task_accounting(self):
+        """
+        Test that background task runs and cycles are accounted
+        """
+        runs = self.tm.scheduler.tasks.can.runs
+        cycles = self.tm.scheduler.tasks.can.cycles
+        for _ in range(10):
+            self.tm.Vbus
+        # Each request is a run of the CAN task, including the ones reading the counters
+        self.assertGreaterEqual((self.tm.scheduler.tasks.can.runs - runs) & 0xFFFFFFFF, 10)
+        self.assertGreater((self.tm.scheduler.tasks.can.cycles - cycles) & 0xFFFFFFFF, 0)
+
+    @pytest.mark.hitl_default
+    def test_h_latency_histograms(self):
+        """
+        Test control loop latency histograms
+        """
+        self.tm.controller.idle()
+        latency = self.tm.scheduler.latency
+        latency.reset()
+        time.sleep(0.2)
+        start_bins = [getattr(latency.start, "bin_{}".format(i)) for i in range(8)]
+        duty_bins = [getattr(latency.duty, "bin_{}".format(i)) for i in range(8)]
+        # Control cycles keep going while the bins are read
+        self.assertGreater(sum(start_bins), 0.2 * 20000)
+        self.assertLess(latency.start.max, 7500)
+        # Duty cycles are not written while idle
+        self.assertEqual(sum(duty_bins), 0)
+        self.assertEqual(latency.duty.max, 0)
 
     @pytest.mark.hitl_default
     def test_i_states(self):
@@ -455,6 +488,38 @@ class TestBoard(TMTestCase):
         self.tm.controller.idle()
         time.sleep(0.4)
 
+    @pytest.mark.hitl_default
+    def test_q_svm_modes(self):
+        """
+        Test velocity control under each modulation scheme
+        """
+        self.reset_and_wait()
+        self.check_state(0)
+        self.try_calibrate()
+        self.tm.controller.voltage.svm_mode = 3  # invalid, should not be set
+        self.assertEqual(self.tm.controller.voltage.svm_mode, 0)
+        for overmodulation in [False, True]:
+            self.tm.controller.voltage.overmodulation = overmodulation
+            for svm_mode in [0, 1, 2]:
+                self.tm.controller.voltage.svm_mode = svm_mode
+                self.assertEqual(self.tm.controller.voltage.svm_mode, svm_mode)
+                self.tm.controller.velocity_mode()
+                self.check_state(2)
+                for v_set in [-100000, 100000]:
+                    self.tm.controller.velocity.setpoint = v_set * ticks / s
+                    time.sleep(0.4)
+                    self.assertAlmostEqual(
+                        v_set * ticks / s,
+                        self.tm.sensors.user_frame.velocity_estimate,
+                        delta=30000 * ticks / s,
+                    )
+                self.tm.controller.velocity.setpoint = 0
+                time.sleep(0.2)
+                self.tm.controller.idle()
+                self.check_state(0)
+        self.tm.controller.voltage.svm_mode = 0
+        self.tm.controller.voltage.overmodulation = False
+
 
 if __name__ == "__main__":
     unittest.main(failfast=True)
@@ -0,0 +1,64 @@
+"""
+Tinymovr Eccentricity Tests
+Copyright Ioannis Chatzikonstantinou 2020-2023
+
+Tests the host reproduction of the eccentricity compensation
+representations on synthetic calibration data.
+
+This program is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <http://www.gnu.org/licenses/>.
+"""
+
+import math
+import random
+import unittest
+from tinymovr.eccentricity import compare, fit_harmonics, TICKS
+
+
+def eccentricity_error(ticks):
+    theta = 2 * math.pi * ticks / TICKS
+    return 40 * math.sin(theta + 0.3) + 12 * math.sin(2 * theta + 1.0)
+
+
+class TestEccentricity(unittest.TestCase):
+    def test_fit_harmonics(self):
+        """
+        Test that the fitted coefficients match the generating series
+        """
+        ref = [i * TICKS / 448 for i in range(448)]
+        err = [eccentricity_error(r) for r in ref]
+        coeffs = fit_harmonics(ref, err, 4)
+        self.assertAlmostEqual(coeffs[0], 0, delta=1e-6)
+        self.assertAlmostEqual(coeffs[1], 40 * math.sin(0.3), delta=1e-6)
+        self.assertAlmostEqual(coeffs[2], 40 * math.cos(0.3), delta=1e-6)
+        self.assertAlmostEqual(coeffs[3], 12 * math.sin(1.0), delta=1e-6)
+        self.assertAlmostEqual(coeffs[4], 12 * math.cos(1.0), delta=1e-6)
+
+    def test_compare(self):
+        """
+        Test that both representations reduce the error of an eccentric
+        magnet, and the Fourier series follows it more closely
+        """
+        random.seed(0)
+        ref = [i * TICKS / 448 for i in range(448)]
+        meas = [
+            (r - eccentricity_error(r) + random.gauss(0, 1)) % TICKS for r in ref
+        ]
+        results = compare(ref, meas, pole_pairs=7, harmonics=8)
+        none_rms, _ = results["none"]
+        table_rms, _ = results["table"]
+        harmonic_rms, _ = results["harmonic"]
+        self.assertLess(table_rms, none_rms / 5)
+        self.assertLess(harmonic_rms, table_rms)
+        self.assertLess(harmonic_rms, 2)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -22,6 +22,7 @@ from avlos.unit_field import get_registry
 
 import unittest
 from tests import TMTestCase
+from tinymovr import nvm_image
 
 ureg = get_registry()
 A = ureg.ampere
@@ -306,7 +307,9 @@ class TestNVM(TMTestCase):
     def test_f_wear_leveling_rotation(self):
         """
         Test that configs rotate through all available wear leveling slots.
-        WARNING: This will perform (num_slots + 2) NVRAM write/erase cycles.
+        Small changes are appended to the current slot until its log is
+        full, after which the full config moves to the next slot.
+        WARNING: This will perform (num_slots + 2) NVRAM erase cycles.
         """
         self.check_state(0)
 
@@ -325,31 +328,38 @@ class TestNVM(TMTestCase):
         self.assertGreaterEqual(num_slots, 2, "Need at least 2 slots for wear leveling")
 
         # Test rotation through all slots + 1 (to verify wraparound)
-        for i in range(num_slots + 1):
+        visited = []
+        writes = 0
+        while len(visited) <= num_slots and writes < 20 * (num_slots + 1):
             # Modify a parameter to ensure config changes
-            self.tm.controller.velocity.p_gain = 1e-5 + i * 1e-6
+            self.tm.controller.velocity.p_gain = 1e-5 + writes * 1e-6
 
             # Save config
             self.save_config()
             time.sleep(0.2)
+            writes += 1
 
-            # Check that we're in the expected slot
             current_slot = self.get_nvm_current_slot()
-            expected_slot = i % num_slots  # After i+1 saves, we should be in slot i
+            if not visited or visited[-1] != current_slot:
+                visited.append(current_slot)
 
-            self.assertEqual(current_slot, expected_slot,
-                f"Slot rotation failed at write {i+1}: expected slot {expected_slot}, got {current_slot}")
+        # Check that slots were visited in order
+        expected_slots = [i % num_slots for i in range(num_slots + 1)]
+        self.assertEqual(visited, expected_slots,
+            f"Slot rotation failed: expected slots {expected_slots}, got {visited}")
+        self.assertGreater(writes, num_slots + 1,
+            "Saves of small changes should be appended to the current slot")
 
         # Verify write count increased
         write_count = self.get_nvm_write_count()
-        self.assertGreaterEqual(write_count, num_slots + 1,
-            f"Write count should be at least {num_slots + 1}, got {write_count}")
+        self.assertGreaterEqual(write_count, writes,
+            f"Write count should be at least {writes}, got {write_count}")
 
         # Reset and verify most recent config loaded
         self.reset_and_wait()
 
         # The last value we wrote should be loaded
-        last_value = 1e-5 + num_slots * 1e-6
+        last_value = 1e-5 + (writes - 1) * 1e-6
         self.assertAlmostEqual(self.tm.controller.velocity.p_gain, last_value,
             places=8, msg="Most recent config not loaded after reset")
 
@@ -417,7 +427,7 @@ class TestNVM(TMTestCase):
     def test_i_slot_fill_and_multiple_wraparounds(self):
         """
         Test that configs correctly wrap around when filling all slots multiple times.
-        WARNING: This will perform (num_slots * 3) NVRAM write cycles.
+        WARNING: This will perform (num_slots * 30) NVRAM write cycles.
         """
         self.check_state(0)
 
@@ -438,8 +448,11 @@ class TestNVM(TMTestCase):
         # Calibrate first
         self.try_calibrate()
 
-        # Write 3× num_slots to force multiple wraparounds
-        total_writes = num_slots * 3
+        # Saves of a small change are appended to the current slot several
+        # times before moving on, so write enough to wrap around repeatedly
+        total_writes = num_slots * 30
+        prev_slot = self.get_nvm_current_slot()
+        slot_changes = 0
 
         for i in range(total_writes):
             # Modify a parameter to ensure config changes
@@ -449,18 +462,17 @@ class TestNVM(TMTestCase):
             self.save_config()
             time.sleep(0.05)
 
-            # Check that we're in the expected slot
+            # Check that the config only ever moves to the next slot
             current_slot = self.get_nvm_current_slot()
-            expected_slot = i % num_slots
-
-            self.assertEqual(current_slot, expected_slot,
-                f"Slot rotation failed at write {i+1}: expected slot {expected_slot}, got {current_slot}")
+            if current_slot != prev_slot:
+                expected_slot = (prev_slot + 1) % num_slots
+                self.assertEqual(current_slot, expected_slot,
+                    f"Slot rotation failed at write {i+1}: expected slot {expected_slot}, got {current_slot}")
+                slot_changes += 1
+            prev_slot = current_slot
 
-        # Verify final slot is correct (should be at (total_writes - 1) % num_slots)
-        final_slot = self.get_nvm_current_slot()
-        expected_final_slot = (total_writes - 1) % num_slots
-        self.assertEqual(final_slot, expected_final_slot,
-            f"Final slot should be {expected_final_slot}, got {final_slot}")
+        self.assertGreaterEqual(slot_changes, 2 * num_slots,
+            f"Expected at least two wraparounds, got {slot_changes} slot changes")
 
         # Reset and verify most recent config loaded
         self.reset_and_wait()
@@ -612,11 +624,13 @@ class TestNVM(TMTestCase):
         self.assertEqual(self.get_nvm_current_slot(), 0,
             "First save should be in slot 0")
 
-        # Perform multiple saves to move to different slots
-        for i in range(3):
+        # Perform saves until the config moves to a different slot
+        for i in range(30):
             self.tm.controller.velocity.p_gain = 1e-5 + i * 1e-6
             self.save_config()
             time.sleep(0.1)
+            if self.get_nvm_current_slot() != 0:
+                break
 
         # Verify we moved past slot 0
         current_slot_before_id_change = self.get_nvm_current_slot()
@@ -705,6 +719,50 @@ class TestNVM(TMTestCase):
         self.erase_config()
         time.sleep(0.2)
 
+    def test_n_host_image_layout(self):
+        """
+        Test that the host NVM image emulator uses the slot layout of
+        the firmware
+        """
+        self.assertEqual(nvm_image.slot_pages(self.tm.config_size), nvm_image.SLOT_PAGES)
+        num_slots = self.get_nvm_num_slots()
+        if num_slots is not None:
+            self.assertEqual(num_slots, nvm_image.SLOT_COUNT)
+
+    def test_o_background_save_no_overruns(self):
+        """
+        Test that a config save while running does not cause control
+        loop overruns
+        WARNING: This will perform two NVRAM writes and two erase cycles.
+        """
+        self.check_state(0)
+        self.erase_config()
+        time.sleep(0.2)
+        self.try_calibrate()
+        # Saving while idle also erases the next slot in advance, so that
+        # the save below only prepares and writes
+        self.save_config()
+        time.sleep(0.2)
+
+        self.tm.controller.position_mode()
+        self.check_state(2)
+        self.tm.controller.velocity.deadband = 200
+        overruns = self.tm.scheduler.overruns
+        self.save_config()
+        deadline = time.time() + 2.0
+        state = self.tm.nvm.save_state
+        while state != 0 and time.time() < deadline:
+            self.assertNotEqual(state, 5, "Background save failed")
+            time.sleep(0.01)
+            state = self.tm.nvm.save_state
+        self.assertEqual(state, 0, "Background save did not complete")
+        self.assertEqual(self.tm.scheduler.overruns, overruns)
+
+        self.tm.controller.idle()
+        time.sleep(0.1)
+        self.erase_config()
+        time.sleep(0.2)
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,225 @@
+"""
+Tinymovr NVM Image Tests
+Copyright Ioannis Chatzikonstantinou 2020-2023
+
+Tests the host reproduction of the config slot layout and boot scan on
+an emulated flash region.
+
+This program is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <http://www.gnu.org/licenses/>.
+"""
+
+import unittest
+import struct
+from tinymovr.nvm_image import (
+    FlashRegion,
+    ConfigStore,
+    make_payload,
+    write_slot,
+    scan,
+    scan_records,
+    scan_sequential,
+    sections,
+    load,
+    crc32,
+    checksum_sum,
+    slot_pages,
+    CONFIG_SIZE,
+    PAGE_COUNT,
+    SLOT_PAGES,
+    SLOT_SIZE,
+    SLOT_COUNT,
+    METADATA_SIZE,
+    METADATA_VERSION_SECTIONS,
+)
+
+PAYLOAD = make_payload([(1, 1, b"1.4.0\x00\x00\x00"), (4, 1, bytes(range(200))), (7, 1, bytes(900))])
+
+
+# Section sizes of the current firmware, by tag
+SECTION_SIZES = {1: 16, 2: 68, 3: 32, 4: 20, 5: 904, 6: 56, 7: 84, 8: 6, 9: 36}
+
+
+def config(frames_offset=0.0, controller=b""):
+    """All sections, with a float in the frames section and optional
+    controller data"""
+    result = []
+    for tag, size in SECTION_SIZES.items():
+        data = bytes(size)
+        if tag == 2:
+            data = struct.pack("<f", frames_offset) + data[4:]
+        elif tag == 7 and controller:
+            data = controller + data[len(controller) :]
+        result.append((tag, 1, data))
+    return result
+
+
+def fill(flash, count, first=1):
+    """Write count configs in turn, as successive saves do"""
+    for i in range(count):
+        write_slot(flash, i % SLOT_COUNT, (first + i) & 0xFFFFFFFF, PAYLOAD)
+
+
+class TestNVMImage(unittest.TestCase):
+    def test_layout(self):
+        """
+        Test that the slot layout follows from the firmware config size,
+        and that a full config of the emulated sections fits in a slot
+        """
+        self.assertEqual(SLOT_PAGES, slot_pages(CONFIG_SIZE))
+        self.assertEqual(SLOT_PAGES * SLOT_COUNT, PAGE_COUNT)
+        self.assertGreaterEqual(SLOT_COUNT, 2)
+        self.assertLessEqual(sum(SECTION_SIZES.values()), CONFIG_SIZE)
+        self.assertLessEqual(METADATA_SIZE + len(make_payload(config())), SLOT_SIZE)
+
+    def test_checksums(self):
+        """
+        Test the CRC-32 check value, and that it detects swapped bytes,
+        which the byte sum does not
+        """
+        self.assertEqual(crc32(b"123456789"), 0xCBF43926)
+        self.assertEqual(checksum_sum(b"\x01\x02"), checksum_sum(b"\x02\x01"))
+        self.assertNotEqual(crc32(b"\x01\x02"), crc32(b"\x02\x01"))
+
+    def test_scan_newest(self):
+        """
+        Test that the newest slot is loaded, and that only that slot is
+        checksummed at boot
+        """
+        flash = FlashRegion()
+        fill(flash, 6)
+        flash.reset_counters()
+        self.assertEqual(scan(flash), (1, 6))
+        self.assertEqual(flash.bytes_checksummed, len(PAYLOAD) - 4 + METADATA_SIZE - 4)
+        cost = flash.bytes_read
+        flash.reset_counters()
+        self.assertEqual(scan_sequential(flash), (1, 6))
+        self.assertLess(cost, flash.bytes_read)
+        self.assertEqual(sections(flash, 1), [(1, 1, 8), (4, 1, 200), (7, 1, 900)])
+
+    def test_fallback(self):
+        """
+        Test that a corrupt newest slot falls back to the one before it,
+        where earlier firmware loaded no config
+        """
+        flash = FlashRegion()
+        fill(flash, 6)
+        flash.data[SLOT_SIZE + METADATA_SIZE + 100] ^= 0x10
+        self.assertEqual(scan(flash), (0, 5))
+        self.assertEqual(scan_sequential(flash), (None, 0))
+
+    def test_interrupted_write(self):
+        """
+        Test that a slot whose write was interrupted before the metadata
+        is ignored
+        """
+        flash = FlashRegion()
+        fill(flash, 2)
+        for page in (4, 5):
+            flash.erase_page(page)
+        flash.write(2 * SLOT_SIZE + METADATA_SIZE, PAYLOAD)
+        self.assertEqual(scan(flash), (1, 2))
+
+    def test_wraparound(self):
+        """
+        Test that sequence numbers wrapping around are ordered correctly
+        """
+        flash = FlashRegion()
+        fill(flash, 6, first=0xFFFFFFFD)
+        self.assertEqual(scan(flash)[0], 1)
+
+    def test_legacy_checksum(self):
+        """
+        Test that slots written with byte sum checksums still load
+        """
+        flash = FlashRegion()
+        payload = make_payload([(4, 1, bytes(64))], METADATA_VERSION_SECTIONS)
+        write_slot(flash, 2, 9, payload, version=METADATA_VERSION_SECTIONS)
+        self.assertEqual(scan(flash), (2, 9))
+
+    def test_empty(self):
+        """
+        Test that an erased region holds no config, and reads only the
+        slot headers
+        """
+        flash = FlashRegion()
+        self.assertEqual(scan(flash), (None, 0))
+        self.assertEqual(flash.bytes_read, 8 * SLOT_COUNT)
+
+    def test_records(self):
+        """
+        Test that saves append the changed sections only, and that they
+        load over the full config of the slot
+        """
+        flash = FlashRegion()
+        store = ConfigStore(flash)
+        self.assertTrue(store.save(config(1.0)))
+        self.assertFalse(store.save(config(1.0)))
+        self.assertTrue(store.save(config(2.0)))
+        self.assertTrue(store.save(config(2.0, b"\x05")))
+        self.assertEqual(scan(flash), (0, 3))
+        records, _ = scan_records(flash, 0)
+        self.assertEqual(len(records), 2)
+        loaded = load(flash)
+        self.assertEqual(struct.unpack("<f", loaded[2][1][:4])[0], 2.0)
+        self.assertEqual(loaded[7][1][0], 5)
+        self.assertEqual(ConfigStore(flash).stored, store.stored)
+
+    def test_torn_record(self):
+        """
+        Test that a partially written record header ends the log, and
+        that the following save moves to the next slot
+        """
+        flash = FlashRegion()
+        store = ConfigStore(flash)
+        store.save(config(1.0))
+        store.save(config(2.0))
+        _, log_end = scan_records(flash, 0)
+        flash.write(log_end, b"\x12")
+        store = ConfigStore(flash)
+        self.assertEqual(store.log_end, SLOT_SIZE)
+        self.assertEqual(struct.unpack("<f", load(flash)[2][1][:4])[0], 2.0)
+        store.save(config(3.0))
+        self.assertEqual(scan(flash), (1, 3))
+
+    def test_node_id_change(self):
+        """
+        Test that a node ID change writes the full config to slot 0
+        """
+        flash = FlashRegion()
+        store = ConfigStore(flash)
+        for i in range(30):
+            store.save(config(float(i)))
+        self.assertNotEqual(store.slot, 0)
+        store.node_id = 5
+        store.save(config(99.0))
+        self.assertEqual(store.slot, 0)
+        self.assertEqual(scan_records(flash, 0)[0], [])
+
+    def test_endurance(self):
+        """
+        Test the wear of frequent saves of a frames offset, against a full
+        slot per save
+        """
+        saves = 2000
+        wear = {}
+        for log in (True, False):
+            flash = FlashRegion()
+            store = ConfigStore(flash, log=log)
+            for i in range(saves):
+                store.save(config(float(i)))
+            self.assertEqual(struct.unpack("<f", load(flash)[2][1][:4])[0], saves - 1)
+            wear[log] = max(flash.erase_counts)
+        self.assertEqual(wear[False], saves // SLOT_COUNT)
+        self.assertLess(wear[True] * 7, wear[False])
+
+
+if __name__ == "__main__":
+    unittest.main()
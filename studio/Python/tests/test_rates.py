@@ -40,6 +40,36 @@ class TestRates(TMTestCase):
         res = elapsed_time()
         print("Round-trip time (2 packets): " + str(res / iterations) + " seconds")
 
+    @pytest.mark.hitl_default
+    def test_tx_queue_accounting(self):
+        """
+        Test that every response to a burst of reads is sent
+        """
+        can = self.tm.comms.can
+        queued = can.tx_queued
+        dropped = can.tx_dropped
+        for _ in range(500):
+            self.tm.Vbus
+        self.assertEqual(can.tx_dropped, dropped)
+        # Includes the responses to reading the counters
+        self.assertGreaterEqual((can.tx_queued - queued) & 0xFFFFFFFF, 500)
+        self.assertLessEqual((can.tx_queued - can.tx_sent) & 0xFFFFFFFF, 8 + 4 + 1)
+
+    @pytest.mark.hitl_default
+    def test_rx_queue_stats(self):
+        """
+        Test receive queue depth and latency of a burst of reads
+        """
+        can = self.tm.comms.can
+        overflows = can.rx_overflows
+        can.reset_rx_stats()
+        for _ in range(500):
+            self.tm.Vbus
+        self.assertEqual(can.rx_overflows, overflows)
+        self.assertGreaterEqual(can.rx_max_depth, 1)
+        # Reads are processed within a few control cycles of arriving
+        self.assertLess(can.rx_max_latency, 20)
+
     # def test_round_trip_time_with_write(self):
     #     """
     #     Test round-trip message time of r/w endpoints (2 packets)
@@ -0,0 +1,177 @@
+"""Tinymovr Eccentricity Compensation Comparison
+
+Usage:
+    tinymovr_eccentricity <file> [--pole_pairs=<n>] [--harmonics=<k>]
+    tinymovr_eccentricity -h | --help
+
+Options:
+    --pole_pairs=<n>  Motor pole pairs, which set the table filter window [default: 7].
+    --harmonics=<k>  Number of harmonics in the Fourier series [default: 8].
+
+The file holds recorded calibration data as comma separated rows of
+reference and measured sensor positions, in ticks (8192 per turn),
+evenly spaced over a whole number of turns. Both firmware
+representations of the eccentricity compensation are fitted to the
+data, and the residual error of each is reported.
+"""
+
+import csv
+import math
+from docopt import docopt
+
+"""
+Tinymovr Eccentricity Module
+Copyright Ioannis Chatzikonstantinou 2020-2023
+
+Host reproduction of the firmware eccentricity compensation, for
+comparing the lookup table and Fourier series representations
+
+This program is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <http://www.gnu.org/licenses/>.
+"""
+
+TICKS = 8192
+TABLE_SIZE = 64
+
+
+def wrap(ticks):
+    """Wrap a distance in ticks to [-TICKS/2, TICKS/2)"""
+    return (ticks + TICKS / 2) % TICKS - TICKS / 2
+
+
+def load(path):
+    """Load reference and measured positions from a csv file"""
+    ref = []
+    meas = []
+    with open(path, newline="") as f:
+        for row in csv.reader(f):
+            try:
+                r, m = float(row[0]), float(row[1])
+            except (ValueError, IndexError):
+                continue  # header or blank line
+            ref.append(r)
+            meas.append(m)
+    return ref, meas
+
+
+def fit_table(ref, err, pole_pairs):
+    """
+    Fit the lookup table as the firmware does: entry i is the error
+    averaged over one electrical period centered at i/64 of a turn.
+    Samples are assumed evenly spaced from the start of a turn.
+    """
+    n = len(err)
+    per_entry = n / TABLE_SIZE
+    window = int(round(n / pole_pairs))
+    table = []
+    for i in range(TABLE_SIZE):
+        center = int(round(i * per_entry))
+        acc = sum(err[(center - window // 2 + j) % n] for j in range(window))
+        table.append(int(acc / window))
+    return table
+
+
+def eval_table(table, angle):
+    """Interpolate the table at an angle in ticks, as the firmware does"""
+    angle = int(angle) % TICKS
+    shift = TICKS // TABLE_SIZE
+    i = angle // shift
+    off_1 = table[i]
+    off_2 = table[(i + 1) % TABLE_SIZE]
+    return off_1 + (((off_2 - off_1) * (angle - i * shift)) // shift)
+
+
+def basis(angle, harmonics):
+    """Fourier basis at an angle in ticks: mean, then cosine and sine by harmonic"""
+    theta = 2 * math.pi * angle / TICKS
+    row = [1.0]
+    for k in range(1, harmonics + 1):
+        row += [math.cos(k * theta), math.sin(k * theta)]
+    return row
+
+
+def solve(a, b):
+    """Solve a x = b by Gaussian elimination with partial pivoting"""
+    n = len(b)
+    m = [list(a[i]) + [b[i]] for i in range(n)]
+    for c in range(n):
+        p = max(range(c, n), key=lambda r: abs(m[r][c]))
+        m[c], m[p] = m[p], m[c]
+        for r in range(c + 1, n):
+            f = m[r][c] / m[c][c]
+            for k in range(c, n + 1):
+                m[r][k] -= f * m[c][k]
+    x = [0.0] * n
+    for r in reversed(range(n)):
+        x[r] = (m[r][n] - sum(m[r][k] * x[k] for k in range(r + 1, n))) / m[r][r]
+    return x
+
+
+def fit_harmonics(ref, err, harmonics):
+    """
+    Least squares fit of the Fourier series coefficients. With evenly
+    spaced samples this matches the projection computed on the device.
+    """
+    size = 2 * harmonics + 1
+    ata = [[0.0] * size for _ in range(size)]
+    atb = [0.0] * size
+    for r, e in zip(ref, err):
+        row = basis(r, harmonics)
+        for i in range(size):
+            atb[i] += row[i] * e
+            for j in range(size):
+                ata[i][j] += row[i] * row[j]
+    return solve(ata, atb)
+
+
+def eval_harmonics(coeffs, angle):
+    """Evaluate the Fourier series at an angle in ticks"""
+    harmonics = (len(coeffs) - 1) // 2
+    return sum(c * v for c, v in zip(coeffs, basis(angle, harmonics)))
+
+
+def stats(residuals):
+    """RMS and peak of a list of residuals"""
+    rms = math.sqrt(sum(r * r for r in residuals) / len(residuals))
+    return rms, max(abs(r) for r in residuals)
+
+
+def compare(ref, meas, pole_pairs=7, harmonics=8):
+    """
+    Fit both representations to the error between reference and measured
+    positions, and return the RMS and peak residual in ticks for no
+    compensation, the lookup table, and the Fourier series.
+    """
+    err = [wrap(r - m) for r, m in zip(ref, meas)]
+    table = fit_table(ref, err, pole_pairs)
+    coeffs = fit_harmonics(ref, err, harmonics)
+    return {
+        "none": stats(err),
+        "table": stats([wrap(r - m - eval_table(table, m)) for r, m in zip(ref, meas)]),
+        "harmonic": stats([wrap(r - m - eval_harmonics(coeffs, m)) for r, m in zip(ref, meas)]),
+    }
+
+
+def spawn():
+    arguments = docopt(__doc__)
+    ref, meas = load(arguments["<file>"])
+    results = compare(
+        ref,
+        meas,
+        pole_pairs=int(arguments["--pole_pairs"]),
+        harmonics=int(arguments["--harmonics"]),
+    )
+    print("{:<10}{:>12}{:>12}".format("", "RMS", "Peak"))
+    for name, (rms, peak) in results.items():
+        print("{:<10}{:>12.2f}{:>12.2f}".format(name, rms, peak))
+
+
+if __name__ == "__main__":
+    spawn()
@@ -0,0 +1,437 @@
+"""Tinymovr NVM Image Inspection
+
+Usage:
+    tinymovr_nvm <file>
+    tinymovr_nvm -h | --help
+
+The file holds a binary dump of the 8 KB config region of the flash
+(0x1E000 to 0x1FFFF), for instance read out through SWD. The slots and
+the records appended to them are listed, and validated as the firmware
+does at boot.
+"""
+
+import struct
+import zlib
+from docopt import docopt
+
+"""
+Tinymovr NVM Image Module
+Copyright Ioannis Chatzikonstantinou 2020-2023
+
+Host reproduction of the firmware config slot layout, boot scan and
+save policy, on an emulated flash region
+
+This program is free software: you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later
+version.
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <http://www.gnu.org/licenses/>.
+"""
+
+PAGE_SIZE = 1024
+ROW_SIZE = 16
+PAGE_COUNT = 8
+# Sections known to the firmware, including the end marker (NVM_TAG_MAX),
+# and the size of each section header
+TAG_COUNT = 10
+SECTION_HEADER_SIZE = 4
+
+
+def slot_pages(config_size):
+    """
+    Pages per slot, derived as the firmware does (SETTINGS_PAGE_COUNT) from
+    the size of its config struct, which the device reports as config_size
+    """
+    payload_max = config_size + TAG_COUNT * (SECTION_HEADER_SIZE + 3) + 4
+    return -(-payload_max // PAGE_SIZE)
+
+
+# sizeof(struct NVMStruct) of the current firmware. test_nvm checks the
+# resulting layout against a device.
+CONFIG_SIZE = 1240
+SLOT_PAGES = slot_pages(CONFIG_SIZE)
+SLOT_SIZE = SLOT_PAGES * PAGE_SIZE
+SLOT_COUNT = PAGE_COUNT // SLOT_PAGES
+
+MAGIC_MARKER = 0x544D4E56
+RECORD_MARKER = 0x544D4E52
+METADATA_VERSION_RAW = 1
+METADATA_VERSION_SECTIONS = 2
+METADATA_VERSION_CRC = 3
+
+# node_id_1, node_id_2, reserved, sequence_number, magic_marker,
+# data_size, metadata_version, metadata_checksum
+METADATA_FORMAT = "<BB14sIIHHI"
+METADATA_SIZE = struct.calcsize(METADATA_FORMAT)
+SEQUENCE_OFFSET = 16
+# sequence_number, magic_marker, data_size, reserved, checksum
+RECORD_FORMAT = "<IIHHI"
+RECORD_HEADER_SIZE = struct.calcsize(RECORD_FORMAT)
+TAG_END = 0
+
+
+def align_row(n):
+    return (n + ROW_SIZE - 1) & ~(ROW_SIZE - 1)
+
+
+def checksum_sum(data):
+    """Byte sum checksum of the legacy formats"""
+    return (-sum(data)) & 0xFFFFFFFF
+
+
+def crc32(data):
+    """CRC-32 as computed by the firmware table, identical to zlib"""
+    return zlib.crc32(bytes(data)) & 0xFFFFFFFF
+
+
+def checksum(version, data):
+    """Checksum used by a given metadata version"""
+    if version >= METADATA_VERSION_CRC:
+        return crc32(data)
+    return checksum_sum(data)
+
+
+def newer(a, b):
+    """Whether sequence number a is newer than b, allowing for wraparound"""
+    return a != b and ((a - b) & 0xFFFFFFFF) < 0xFFFFFFFF // 2
+
+
+class FlashRegion:
+    """
+    Emulated config region. Erasing sets a page to 0xFF, and programming
+    can only clear bits, once per row between erases. Reads are counted,
+    as a measure of boot cost, and erases by page, as a measure of wear.
+    """
+
+    def __init__(self, image=None):
+        if image is None:
+            image = b"\xff" * (PAGE_COUNT * PAGE_SIZE)
+        assert len(image) == PAGE_COUNT * PAGE_SIZE
+        self.data = bytearray(image)
+        self.erase_counts = [0] * PAGE_COUNT
+        self.bytes_read = 0
+        self.bytes_checksummed = 0
+
+    def erase_page(self, page):
+        self.data[page * PAGE_SIZE : (page + 1) * PAGE_SIZE] = b"\xff" * PAGE_SIZE
+        self.erase_counts[page] += 1
+
+    def blank(self, offset, length):
+        return all(b == 0xFF for b in self.data[offset : offset + length])
+
+    def write(self, offset, data):
+        first = offset - offset % ROW_SIZE
+        if not self.blank(first, align_row(offset + len(data)) - first):
+            raise ValueError("row at {} programmed twice".format(offset))
+        for i, b in enumerate(data):
+            self.data[offset + i] &= b
+
+    def read(self, offset, length):
+        self.bytes_read += length
+        return bytes(self.data[offset : offset + length])
+
+    def checksum(self, version, offset, length):
+        self.bytes_checksummed += length
+        return checksum(version, self.read(offset, length))
+
+    def reset_counters(self):
+        self.bytes_read = 0
+        self.bytes_checksummed = 0
+
+
+def make_payload(sections, version=METADATA_VERSION_CRC):
+    """
+    Serialize (tag, section version, bytes) records as the firmware does,
+    followed by an end marker and the payload checksum
+    """
+    body = b""
+    for tag, section_version, data in sections:
+        body += struct.pack("<BBH", tag, section_version, len(data))
+        body += data + b"\x00" * (-len(data) % 4)
+    body += struct.pack("<BBH", TAG_END, 0, 0)
+    return body + struct.pack("<I", checksum(version, body))
+
+
+def make_record(sequence, payload):
+    """Record header followed by a payload of changed sections"""
+    head = struct.pack(RECORD_FORMAT[:-1], sequence, RECORD_MARKER, len(payload), 0)
+    return head + struct.pack("<I", crc32(head)) + payload
+
+
+def make_metadata(sequence, data_size, node_id=1, version=METADATA_VERSION_CRC):
+    head = struct.pack(
+        METADATA_FORMAT[:-1],
+        node_id,
+        node_id,
+        b"\x00" * 14,
+        sequence,
+        MAGIC_MARKER,
+        data_size,
+        version,
+    )
+    return head + struct.pack("<I", checksum(version, head))
+
+
+def write_slot(flash, slot, sequence, payload, node_id=1, version=METADATA_VERSION_CRC):
+    """Erase a slot and write a config to it"""
+    for page in range(slot * SLOT_PAGES, (slot + 1) * SLOT_PAGES):
+        flash.erase_page(page)
+    metadata = make_metadata(sequence, len(payload), node_id, version)
+    flash.write(slot * SLOT_SIZE, metadata + payload)
+
+
+def read_metadata(flash, slot):
+    fields = struct.unpack(
+        METADATA_FORMAT, flash.read(slot * SLOT_SIZE, METADATA_SIZE)
+    )
+    keys = (
+        "node_id_1",
+        "node_id_2",
+        "reserved",
+        "sequence_number",
+        "magic_marker",
+        "data_size",
+        "metadata_version",
+        "metadata_checksum",
+    )
+    return dict(zip(keys, fields))
+
+
+def validate_slot(flash, slot, raw_size=None, payload=True):
+    """
+    Validate metadata and payload checksums of a slot. Raw slots of
+    metadata version 1 carry their checksum as the last word of the
+    NVMStruct, whose size raw_size must then be given.
+    """
+    base = slot * SLOT_SIZE
+    md = read_metadata(flash, slot)
+    version = md["metadata_version"]
+    if md["magic_marker"] != MAGIC_MARKER:
+        return False
+    if not METADATA_VERSION_RAW <= version <= METADATA_VERSION_CRC:
+        return False
+    if md["data_size"] == 0 or md["data_size"] > SLOT_SIZE - METADATA_SIZE:
+        return False
+    if flash.checksum(version, base, METADATA_SIZE - 4) != md["metadata_checksum"]:
+        return False
+    if not payload:
+        return True
+    if version == METADATA_VERSION_RAW:
+        if raw_size is None or md["data_size"] != raw_size:
+            return False
+    body = md["data_size"] - 4
+    if body < 4:
+        return False
+    (stored,) = struct.unpack("<I", flash.read(base + METADATA_SIZE + body, 4))
+    return flash.checksum(version, base + METADATA_SIZE, body) == stored
+
+
+def scan(flash, raw_size=None):
+    """
+    Find the slot the firmware loads at boot. Slots carrying the magic
+    marker are indexed by sequence number, then validated newest first.
+    Returns the slot and its sequence number, or (None, 0).
+    """
+    candidates = []
+    for slot in range(SLOT_COUNT):
+        magic_and_sequence = flash.read(slot * SLOT_SIZE + SEQUENCE_OFFSET, 8)
+        sequence, magic = struct.unpack("<II", magic_and_sequence)
+        if magic != MAGIC_MARKER:
+            continue
+        i = len(candidates)
+        while i > 0 and newer(sequence, candidates[i - 1][1]):
+            i -= 1
+        candidates.insert(i, (slot, sequence))
+    for slot, sequence in candidates:
+        if validate_slot(flash, slot, raw_size):
+            records, _ = scan_records(flash, slot)
+            if records:
+                sequence = records[-1][1]
+            return slot, sequence
+    return None, 0
+
+
+def scan_records(flash, slot):
+    """
+    Walk the records appended to a valid slot by their headers. Returns
+    a list of (offset, sequence number, payload size) and the offset
+    where the next record goes. A header that is neither valid nor blank
+    ends the log and marks it full.
+    """
+    base = slot * SLOT_SIZE
+    pos = align_row(METADATA_SIZE + read_metadata(flash, slot)["data_size"])
+    records = []
+    while pos + RECORD_HEADER_SIZE <= SLOT_SIZE:
+        raw = flash.read(base + pos, RECORD_HEADER_SIZE)
+        if raw == b"\xff" * RECORD_HEADER_SIZE:
+            break
+        sequence, marker, size, _, stored = struct.unpack(RECORD_FORMAT, raw)
+        end = pos + align_row(RECORD_HEADER_SIZE + size)
+        if marker != RECORD_MARKER or crc32(raw[:-4]) != stored or end > SLOT_SIZE:
+            return records, SLOT_SIZE
+        records.append((pos, sequence, size))
+        pos = end
+    return records, pos
+
+
+def scan_sequential(flash, raw_size=None):
+    """
+    Boot scan of earlier firmware, for comparison: the metadata of every
+    slot is validated in turn, and the payload of the newest one when
+    loading it, without falling back to an older slot if it is corrupt.
+    """
+    best = None
+    for slot in range(SLOT_COUNT):
+        if validate_slot(flash, slot, payload=False):
+            sequence = read_metadata(flash, slot)["sequence_number"]
+            if best is None or newer(sequence, best[1]):
+                best = (slot, sequence)
+    if best is None or not validate_slot(flash, best[0], raw_size):
+        return None, 0
+    return best
+
+
+def parse_sections(payload):
+    """List the (tag, version, data) records of a payload of tagged sections"""
+    end = len(payload) - 4
+    pos = 0
+    records = []
+    while pos + 4 <= end:
+        tag, version, length = struct.unpack("<BBH", payload[pos : pos + 4])
+        pos += 4
+        if tag == TAG_END:
+            break
+        records.append((tag, version, payload[pos : pos + length]))
+        pos += (length + 3) & ~3
+    return records
+
+
+def sections(flash, slot):
+    """List the (tag, version, length) records of a sectioned slot"""
+    md = read_metadata(flash, slot)
+    payload = flash.read(slot * SLOT_SIZE + METADATA_SIZE, md["data_size"])
+    return [(tag, version, len(data)) for tag, version, data in parse_sections(payload)]
+
+
+def load(flash):
+    """
+    Sections as loaded by the firmware, by tag: those of the newest valid
+    slot, updated by the valid records appended to it in turn
+    """
+    slot, _ = scan(flash)
+    if slot is None:
+        return {}
+    base = slot * SLOT_SIZE
+    md = read_metadata(flash, slot)
+    payload = flash.read(base + METADATA_SIZE, md["data_size"])
+    loaded = {tag: (v, d) for tag, v, d in parse_sections(payload)}
+    for pos, _, size in scan_records(flash, slot)[0]:
+        payload = flash.read(base + pos + RECORD_HEADER_SIZE, size)
+        if size >= 8 and crc32(payload[:-4]) == struct.unpack("<I", payload[-4:])[0]:
+            loaded.update({tag: (v, d) for tag, v, d in parse_sections(payload)})
+    return loaded
+
+
+def section_crc(tag, version, data):
+    return crc32(struct.pack("<BBH", tag, version, len(data)) + data)
+
+
+class ConfigStore:
+    """
+    Save policy of the firmware: the sections changed since the last save
+    are appended as a record to the current slot while there is room,
+    otherwise all sections are written to the next slot. With log set to
+    False every save writes a slot, as earlier firmware did.
+    """
+
+    def __init__(self, flash, node_id=1, log=True):
+        self.flash = flash
+        self.node_id = node_id
+        self.log = log
+        self.slot, self.sequence = scan(flash)
+        self.stored = {}
+        self.log_end = SLOT_SIZE
+        if self.slot is not None:
+            self.log_end = scan_records(flash, self.slot)[1]
+            self.stored = {
+                tag: section_crc(tag, v, d) for tag, (v, d) in load(flash).items()
+            }
+
+    def save(self, sections):
+        """Save a list of (tag, version, data). Returns False if nothing changed."""
+        crcs = {tag: section_crc(tag, v, d) for tag, v, d in sections}
+        changed = [s for s in sections if crcs[s[0]] != self.stored.get(s[0])]
+        node_changed = (
+            self.slot is not None
+            and read_metadata(self.flash, self.slot)["node_id_1"] != self.node_id
+        )
+        full = self.slot is None or node_changed or not self.log
+        if not full and not changed:
+            return False
+        sequence = (self.sequence + 1) & 0xFFFFFFFF or 1
+        if not full:
+            record = make_record(sequence, make_payload(changed))
+            size = align_row(len(record))
+            offset = self.slot * SLOT_SIZE + self.log_end
+            if self.log_end + size <= SLOT_SIZE and self.flash.blank(offset, size):
+                self.flash.write(offset, record)
+                self.log_end += size
+                self.sequence = sequence
+                self.stored = crcs
+                return True
+        # Slot 0 always holds the current node ID, for the bootloader
+        if self.slot is None or node_changed:
+            slot = 0
+        else:
+            slot = (self.slot + 1) % SLOT_COUNT
+        payload = make_payload(sections)
+        write_slot(self.flash, slot, sequence, payload, self.node_id)
+        self.slot = slot
+        self.sequence = sequence
+        self.log_end = align_row(METADATA_SIZE + len(payload))
+        self.stored = crcs
+        return True
+
+
+def spawn():
+    arguments = docopt(__doc__)
+    with open(arguments["<file>"], "rb") as f:
+        flash = FlashRegion(f.read())
+    for slot in range(SLOT_COUNT):
+        md = read_metadata(flash, slot)
+        if md["magic_marker"] != MAGIC_MARKER:
+            print("slot {}: empty".format(slot))
+            continue
+        print(
+            "slot {}: sequence {} version {} size {} node {} {}".format(
+                slot,
+                md["sequence_number"],
+                md["metadata_version"],
+                md["data_size"],
+                md["node_id_1"],
+                "valid" if validate_slot(flash, slot) else "INVALID",
+            )
+        )
+        if md["metadata_version"] != METADATA_VERSION_RAW:
+            for tag, version, length in sections(flash, slot):
+                print("    tag {} version {} length {}".format(tag, version, length))
+        if validate_slot(flash, slot):
+            for pos, sequence, size in scan_records(flash, slot)[0]:
+                payload = flash.read(slot * SLOT_SIZE + pos + RECORD_HEADER_SIZE, size)
+                tags = [tag for tag, _, _ in parse_sections(payload)]
+                print("    record at {}: sequence {} tags {}".format(pos, sequence, tags))
+    flash.reset_counters()
+    slot, sequence = scan(flash)
+    print(
+        "boot loads slot {} (sequence {}), reading {} bytes".format(
+            slot, sequence, flash.bytes_read
+        )
+    )
+
+
+if __name__ == "__main__":
+    spawn()